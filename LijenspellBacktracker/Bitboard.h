@@ -0,0 +1,242 @@
+//
+// Bitboard.h : Bit parallel board representation for the Lijenspel backtracker
+//
+//  Every cell state (each arrow, number, empty) gets one 64 bit word per row, and a transposed copy with one word per column.
+//  Looking along a ray from a number is then a shift and a bit scan on a single word instead of walking the grid a character
+//  at a time, and checks like "is the board full" are a handful of word compares.
+//  Bit n of a row word is column n, bit n of a column word is row n, so right and down are towards the high bits.
+//
+//  Boards can be at most 64x64.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h> //memset
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//Cell states, arrow states share their index with the arrows array (and the arrow codes of the squares grid)
+enum CellState { UP = 0, RIGHT = 1, DOWN = 2, LEFT = 3, NUMBER = 4, EMPTY = 5, NUM_STATES = 6 };
+
+const int MAX_BOARD_SIZE = 64;
+
+//The 64 bit popcnt and bit scans only exist on x64, 32 bit builds do each half of the word with the 32 bit ones
+#if defined(_MSC_VER) && defined(_M_IX86)
+#define HALF_WORD_BITS
+#endif
+
+//Number of set bits
+inline int popCount(uint64_t x) {
+#if defined(HALF_WORD_BITS)
+	return (int)(__popcnt((unsigned int)x) + __popcnt((unsigned int)(x >> 32)));
+#elif defined(_MSC_VER)
+	return (int)__popcnt64(x);
+#else
+	return __builtin_popcountll(x);
+#endif
+}
+
+//Index of the lowest set bit, x can't be 0
+inline int lowestBit(uint64_t x) {
+#if defined(HALF_WORD_BITS)
+	unsigned long idx;
+	if (_BitScanForward(&idx, (unsigned long)x)) {
+		return (int)idx;
+	}
+	_BitScanForward(&idx, (unsigned long)(x >> 32));
+	return (int)idx + 32;
+#elif defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward64(&idx, x);
+	return (int)idx;
+#else
+	return __builtin_ctzll(x);
+#endif
+}
+
+//Index of the highest set bit, x can't be 0
+inline int highestBit(uint64_t x) {
+#if defined(HALF_WORD_BITS)
+	unsigned long idx;
+	if (_BitScanReverse(&idx, (unsigned long)(x >> 32))) {
+		return (int)idx + 32;
+	}
+	_BitScanReverse(&idx, (unsigned long)x);
+	return (int)idx;
+#elif defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanReverse64(&idx, x);
+	return (int)idx;
+#else
+	return 63 - __builtin_clzll(x);
+#endif
+}
+
+//Is this direction towards the high bits of its line word
+inline bool towardsHigh(int dir) {
+	return dir == RIGHT || dir == DOWN;
+}
+
+//Is this direction along a row (so it uses the row words)
+inline bool horizontal(int dir) {
+	return dir == RIGHT || dir == LEFT;
+}
+
+//Mask of the run of set bits in line that starts right next to pos and heads off in dir
+inline uint64_t rayRun(uint64_t line, int pos, int dir) {
+	int length;
+	if (towardsHigh(dir)) {
+		if (pos >= 63) {
+			return 0;
+		}
+		//Top bit of the shifted word is always 0 so the complement always has a bit to find
+		length = lowestBit(~(line >> (pos + 1)));
+		return ((((uint64_t)1) << length) - 1) << (pos + 1);
+	}
+	else {
+		if (pos <= 0) {
+			return 0;
+		}
+		length = 63 - highestBit(~(line << (64 - pos)));
+		return ((((uint64_t)1) << length) - 1) << (pos - length);
+	}
+}
+
+//Keeps only the first count set bits of mask, counting out from the start of a ray in dir
+inline uint64_t firstAlongRay(uint64_t mask, int count, int dir) {
+	uint64_t rest = mask;
+	for (int i = 0; i < count && rest != 0; i++) {
+		if (towardsHigh(dir)) {
+			rest &= rest - 1;
+		}
+		else {
+			rest ^= ((uint64_t)1) << highestBit(rest);
+		}
+	}
+	return mask ^ rest;
+}
+
+//Mask of every bit from the start of a ray in dir up to and including bit pos
+inline uint64_t upToAlongRay(int pos, int dir) {
+	if (towardsHigh(dir)) {
+		//pos of 63 wraps to all ones which is what we want
+		return (((uint64_t)2) << pos) - 1;
+	}
+	return ~((((uint64_t)1) << pos) - 1);
+}
+
+struct Bitboard {
+	int rows, cols;
+	//rowBits[state][row] bit col is set when the cell is in that state
+	uint64_t rowBits[NUM_STATES][MAX_BOARD_SIZE];
+	//colBits[state][col] bit row is the same thing transposed
+	uint64_t colBits[NUM_STATES][MAX_BOARD_SIZE];
+
+	//Sets up an all empty board
+	void reset(int numRows, int numCols) {
+		rows = numRows;
+		cols = numCols;
+		memset(rowBits, 0, sizeof(rowBits));
+		memset(colBits, 0, sizeof(colBits));
+		for (int n = 0; n < rows; n++) {
+			rowBits[EMPTY][n] = lineMask(cols);
+		}
+		for (int m = 0; m < cols; m++) {
+			colBits[EMPTY][m] = lineMask(rows);
+		}
+	}
+
+	//All bits of a line that are on the board
+	static uint64_t lineMask(int length) {
+		return length >= 64 ? ~(uint64_t)0 : (((uint64_t)1) << length) - 1;
+	}
+
+	//State of a single cell
+	int get(int row, int col) const {
+		for (int s = 0; s < NUM_STATES; s++) {
+			if ((rowBits[s][row] >> col) & 1) {
+				return s;
+			}
+		}
+		return EMPTY;
+	}
+
+	//Changes the state of a single cell
+	void set(int row, int col, int state) {
+		int old = get(row, col);
+		rowBits[old][row] &= ~(((uint64_t)1) << col);
+		colBits[old][col] &= ~(((uint64_t)1) << row);
+		rowBits[state][row] |= ((uint64_t)1) << col;
+		colBits[state][col] |= ((uint64_t)1) << row;
+	}
+
+	//The word holding the line a ray from (row, col) in dir travels along
+	uint64_t line(int state, int row, int col, int dir) const {
+		return horizontal(dir) ? rowBits[state][row] : colBits[state][col];
+	}
+
+	//Where (row, col) sits inside the line word for dir
+	static int linePos(int row, int col, int dir) {
+		return horizontal(dir) ? col : row;
+	}
+
+	//Finds the cell steps squares away from (row, col) in dir, false if that is off the board
+	bool step(int row, int col, int dir, int steps, int &outRow, int &outCol) const {
+		outRow = row;
+		outCol = col;
+		if (horizontal(dir)) {
+			outCol += towardsHigh(dir) ? steps : -steps;
+		}
+		else {
+			outRow += towardsHigh(dir) ? steps : -steps;
+		}
+		return outRow >= 0 && outRow < rows && outCol >= 0 && outCol < cols;
+	}
+
+	//Arrows pointing in dir chained directly onto (row, col)
+	uint64_t ownRay(int row, int col, int dir) const {
+		return rayRun(line(dir, row, col, dir), linePos(row, col, dir), dir);
+	}
+
+	//Number of arrows pointing in dir chained directly onto (row, col)
+	int ownRun(int row, int col, int dir) const {
+		return popCount(ownRay(row, col, dir));
+	}
+
+	//Cells a number at (row, col) could extend through in dir, its own arrows cost nothing and anything else stops it
+	uint64_t openRay(int row, int col, int dir) const {
+		return rayRun(line(EMPTY, row, col, dir) | line(dir, row, col, dir), linePos(row, col, dir), dir);
+	}
+
+	//Cells past a number's chain in dir it could still take, loose arrows of its direction sitting out there count too
+	uint64_t freeRay(int row, int col, int dir) const {
+		return openRay(row, col, dir) & ~ownRay(row, col, dir);
+	}
+
+	//Empty cells a number at (row, col) could still fill in dir with remaining arrows left to place
+	uint64_t reach(int row, int col, int dir, int remaining) const {
+		return firstAlongRay(freeRay(row, col, dir), remaining, dir) & line(EMPTY, row, col, dir);
+	}
+
+	//Number of cells in a state
+	int count(int state) const {
+		int total = 0;
+		for (int n = 0; n < rows; n++) {
+			total += popCount(rowBits[state][n]);
+		}
+		return total;
+	}
+
+	//No empty cells left
+	bool isFull() const {
+		for (int n = 0; n < rows; n++) {
+			if (rowBits[EMPTY][n] != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
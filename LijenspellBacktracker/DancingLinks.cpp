@@ -0,0 +1,123 @@
+//
+// DancingLinks.cpp : Knuth's Algorithm X on dancing links, for solving a puzzle as an exact cover problem
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DancingLinks.h"
+using namespace std;
+
+//Sets up an empty matrix with this many columns
+DancingLinks::DancingLinks(int columns) {
+	guesses = 0;
+	numColumns = columns;
+	numRows = 0;
+	stopped = false;
+	sizes.assign(columns + 1, 0);
+
+	//Root and headers all in one circular list
+	for (int c = 0; c <= columns; c++) {
+		Node header;
+		header.left = c == 0 ? columns : c - 1;
+		header.right = c == columns ? 0 : c + 1;
+		header.up = c;
+		header.down = c;
+		header.column = c;
+		header.row = -1;
+		nodes.push_back(header);
+	}
+}
+
+//Adds a row covering the given columns
+int DancingLinks::addRow(const vector<int> &columns) {
+	int first = (int)nodes.size();
+	for (int i = 0; i < (int)columns.size(); i++) {
+		//Headers are 1 based since the root is 0
+		int c = columns[i] + 1;
+		Node node;
+		node.column = c;
+		node.row = numRows;
+		node.left = i == 0 ? first + (int)columns.size() - 1 : first + i - 1;
+		node.right = i == (int)columns.size() - 1 ? first : first + i + 1;
+
+		//Goes on the bottom of its column
+		node.down = c;
+		node.up = nodes[c].up;
+		int index = (int)nodes.size();
+		nodes[nodes[c].up].down = index;
+		nodes[c].up = index;
+		sizes[c]++;
+		nodes.push_back(node);
+	}
+	return numRows++;
+}
+
+//Takes a column out of the header list, along with every row that uses it
+void DancingLinks::cover(int column) {
+	nodes[nodes[column].right].left = nodes[column].left;
+	nodes[nodes[column].left].right = nodes[column].right;
+	for (int i = nodes[column].down; i != column; i = nodes[i].down) {
+		for (int j = nodes[i].right; j != i; j = nodes[j].right) {
+			nodes[nodes[j].down].up = nodes[j].up;
+			nodes[nodes[j].up].down = nodes[j].down;
+			sizes[nodes[j].column]--;
+		}
+	}
+}
+
+//Exactly undoes cover, has to be done in the reverse order
+void DancingLinks::uncover(int column) {
+	for (int i = nodes[column].up; i != column; i = nodes[i].up) {
+		for (int j = nodes[i].left; j != i; j = nodes[j].left) {
+			sizes[nodes[j].column]++;
+			nodes[nodes[j].down].up = j;
+			nodes[nodes[j].up].down = j;
+		}
+	}
+	nodes[nodes[column].right].left = column;
+	nodes[nodes[column].left].right = column;
+}
+
+void DancingLinks::search(function<bool(const vector<int>&)> &found) {
+	//Every column is covered so this is a solution
+	if (nodes[0].right == 0) {
+		if (!found(chosen)) {
+			stopped = true;
+		}
+		return;
+	}
+
+	//Branch on the column with the fewest ways to cover it
+	int column = nodes[0].right;
+	for (int c = nodes[column].right; c != 0; c = nodes[c].right) {
+		if (sizes[c] < sizes[column]) {
+			column = c;
+		}
+	}
+	if (sizes[column] == 0) {
+		return;
+	}
+	if (sizes[column] > 1) {
+		guesses++;
+	}
+
+	cover(column);
+	for (int i = nodes[column].down; i != column && !stopped; i = nodes[i].down) {
+		chosen.push_back(nodes[i].row);
+		for (int j = nodes[i].right; j != i; j = nodes[j].right) {
+			cover(nodes[j].column);
+		}
+		search(found);
+		for (int j = nodes[i].left; j != i; j = nodes[j].left) {
+			uncover(nodes[j].column);
+		}
+		chosen.pop_back();
+	}
+	uncover(column);
+}
+
+//Finds every exact cover
+void DancingLinks::solve(function<bool(const vector<int>&)> found) {
+	stopped = false;
+	chosen.clear();
+	search(found);
+}
@@ -0,0 +1,48 @@
+//
+// DancingLinks.h : Knuth's Algorithm X on dancing links, for solving a puzzle as an exact cover problem
+//
+//  Every column has to be covered by exactly one chosen row. The matrix is kept as four way linked nodes
+//  (all sitting in one vector and linked by index) so covering and uncovering a column is just relinking,
+//  and the search always branches on the column with the fewest rows left.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+class DancingLinks {
+public:
+	//Sets up an empty matrix with this many columns
+	explicit DancingLinks(int columns);
+
+	//Adds a row covering the given columns, gives back its id (rows are numbered in the order they are added)
+	int addRow(const std::vector<int> &columns);
+
+	//Finds every exact cover, found is handed the row ids of each one and can return false to stop the search
+	void solve(std::function<bool(const std::vector<int>&)> found);
+
+	//Times the search had to pick between more than one row
+	double guesses;
+
+private:
+	struct Node {
+		int left, right, up, down;
+		int column, row;
+	};
+
+	//Node 0 is the root, nodes 1 to numColumns are the column headers, everything after is the rows
+	std::vector<Node> nodes;
+	std::vector<int> sizes;
+	int numColumns;
+	int numRows;
+
+	//Rows picked on the way down to the current search node
+	std::vector<int> chosen;
+	bool stopped;
+
+	void cover(int column);
+	void uncover(int column);
+	void search(std::function<bool(const std::vector<int>&)> &found);
+};
@@ -0,0 +1,455 @@
+//
+// Generator.cpp : Makes new puzzles by laying down a solution first and working the clues out from it
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "Generator.h"
+#include "Solver.h"
+#include "WorkStealingPool.h"
+using namespace std;
+
+//Which way each direction steps, UP RIGHT DOWN LEFT
+static const int rowStep[4] = { -1, 0, 1, 0 };
+static const int colStep[4] = { 0, 1, 0, -1 };
+
+//Memory for the table of each uniqueness check, they are small quick searches so a big one just costs clearing it
+static const size_t CHECK_TABLE_BYTES = 64 * 1024;
+
+//Sets up a generator for puzzles rows by cols
+Generator::Generator(int rows, int cols, uint64_t seed) : random(seed) {
+	numRows = rows;
+	numCols = cols;
+	maxSplits = rows * cols / 2;
+	restarts = 0;
+	maxRestarts = 10000;
+	lowestRating = 0;
+	highestRating = 10;
+	rating = 0;
+	tiling = newGrid(rows, cols);
+}
+
+Generator::~Generator() {
+	deleteGrid(tiling, numRows);
+}
+
+//Makes a new puzzle with exactly one solution, rated from lowestRating to highestRating
+// Tilings that get stuck, need too many splits to pin down, or miss the ratings just get thrown out. Making one is cheap,
+// but some boards (1x1 has nowhere for an arrow) never get one through, so it gives up after maxRestarts.
+Cell** Generator::generate() {
+	int start = restarts;
+	while (restarts - start < maxRestarts) {
+		if (!tile()) {
+			restarts++;
+			continue;
+		}
+		//Split arms where another solution differs until there isn't one
+		vector<int> differ;
+		int splits = 0;
+		bool unique = false;
+		while (splits <= maxSplits) {
+			if (otherSolution(differ, rating) == 1) {
+				unique = true;
+				break;
+			}
+			shuffle(differ);
+			bool split = false;
+			for (int i = 0; i < differ.size() && !split; i++) {
+				split = splitAt(differ[i] / numCols, differ[i] % numCols);
+			}
+			if (!split) {
+				break;
+			}
+			splits++;
+		}
+		//Merging mostly makes it harder, so too hard already won't come right
+		if (!unique || rating > highestRating) {
+			restarts++;
+			continue;
+		}
+		mergeNumbers();
+		if (rating < lowestRating) {
+			restarts++;
+			continue;
+		}
+
+		Cell** solution = newGrid(numRows, numCols);
+		for (int n = 0; n < numRows; n++) {
+			for (int m = 0; m < numCols; m++) {
+				solution[n][m] = tiling[n][m];
+			}
+		}
+		return solution;
+	}
+	return NULL;
+}
+
+//Starts the random numbers over on a stream of seed
+void Generator::reseed(uint64_t seed, uint64_t stream) {
+	random = Random(seed, stream);
+}
+
+//Covers the whole board with numbers and their arms
+// Empty squares get visited in a random order, each one either carries on the arm of a number next to it or becomes
+// a number itself and grows arms out over the empty squares around it.
+// returns: false if a square got boxed in with neither, then it's time for a new tiling
+bool Generator::tile() {
+	vector<int> order;
+	for (int n = 0; n < numRows; n++) {
+		for (int m = 0; m < numCols; m++) {
+			tiling[n][m] = BLANK;
+			order.push_back(n * numCols + m);
+		}
+	}
+	shuffle(order);
+
+	//Numbers mostly start small, merging grows them later
+	int biggest = max(2, (numRows + numCols) / 3);
+	for (int i = 0; i < order.size(); i++) {
+		int row = order[i] / numCols;
+		int col = order[i] % numCols;
+		if (tiling[row][col] != BLANK) {
+			continue;
+		}
+		//Arms that could carry on into here, the square behind has to be a number or the end of an arm pointing this way
+		int extend[4];
+		int numExtend = 0;
+		bool roomToGrow = false;
+		for (int dir = 0; dir < 4; dir++) {
+			int behindRow = row - rowStep[dir];
+			int behindCol = col - colStep[dir];
+			if (behindRow < 0 || behindRow >= numRows || behindCol < 0 || behindCol >= numCols) {
+				continue;
+			}
+			Cell behind = tiling[behindRow][behindCol];
+			if (isClueCell(behind) || behind == ARROW_CELL + dir) {
+				extend[numExtend++] = dir;
+			}
+			if (behind == BLANK) {
+				roomToGrow = true;
+			}
+		}
+		if (numExtend > 0 && (!roomToGrow || random.below(2) == 0)) {
+			int dir = extend[random.below(numExtend)];
+			tiling[row][col] = (Cell)(ARROW_CELL + dir);
+			int ownerRow, ownerCol;
+			findOwner(row, col, ownerRow, ownerCol);
+			tiling[ownerRow][ownerCol]++;
+		}
+		else if (roomToGrow) {
+			growNumber(row, col, 1 + random.below(biggest));
+		}
+		else if (!takeArmEnd(row, col)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//Makes a number on an empty square and grows its arms an arrow at a time in random directions
+// Stops at target arrows or once every arm has run into something. There's always at least one empty square next to it.
+void Generator::growNumber(int row, int col, int target) {
+	int length[4] = { 0, 0, 0, 0 };
+	int total = 0;
+	while (total < target) {
+		int open[4];
+		int numOpen = 0;
+		for (int dir = 0; dir < 4; dir++) {
+			int n = row + rowStep[dir] * (length[dir] + 1);
+			int m = col + colStep[dir] * (length[dir] + 1);
+			if (n >= 0 && n < numRows && m >= 0 && m < numCols && tiling[n][m] == BLANK) {
+				open[numOpen++] = dir;
+			}
+		}
+		if (numOpen == 0) {
+			break;
+		}
+		int dir = open[random.below(numOpen)];
+		length[dir]++;
+		total++;
+		tiling[row + rowStep[dir] * length[dir]][col + colStep[dir] * length[dir]] = (Cell)(ARROW_CELL + dir);
+	}
+	tiling[row][col] = (Cell)total;
+}
+
+//The number an arrow belongs to, back along the arrows pointing the same way
+void Generator::findOwner(int row, int col, int &ownerRow, int &ownerCol) const {
+	int dir = tiling[row][col] - ARROW_CELL;
+	while (tiling[row][col] == ARROW_CELL + dir) {
+		row -= rowStep[dir];
+		col -= colStep[dir];
+	}
+	ownerRow = row;
+	ownerCol = col;
+}
+
+//How many arrows in a row point in dir starting next to a square
+int Generator::armLength(int row, int col, int dir) const {
+	int length = 0;
+	while (true) {
+		int n = row + rowStep[dir] * (length + 1);
+		int m = col + colStep[dir] * (length + 1);
+		if (n < 0 || n >= numRows || m < 0 || m >= numCols || tiling[n][m] != ARROW_CELL + dir) {
+			return length;
+		}
+		length++;
+	}
+}
+
+//Turns an arrow into a number, it takes the rest of the arm past it and its old number keeps the part before
+// At the very end of an arm the square before it becomes the number instead, so the new number owns the end.
+// An arm only the one square long has nothing to split, that square has to take an arrow from next to it instead.
+// Either way the old number has to be left with something.
+// returns: false if there was no way to make the square (or the one before it) a number
+bool Generator::splitAt(int row, int col) {
+	int dir = tiling[row][col] - ARROW_CELL;
+	int ownerRow, ownerCol;
+	findOwner(row, col, ownerRow, ownerCol);
+	int along = abs(row - ownerRow) + abs(col - ownerCol);
+	int length = armLength(ownerRow, ownerCol, dir);
+	if (along == length) {
+		if (length == 1) {
+			if (tiling[ownerRow][ownerCol] == 1) {
+				return false;
+			}
+			tiling[row][col] = BLANK;
+			tiling[ownerRow][ownerCol]--;
+			if (!takeArmEnd(row, col)) {
+				tiling[ownerRow][ownerCol]++;
+				tiling[row][col] = (Cell)(ARROW_CELL + dir);
+				return false;
+			}
+			return true;
+		}
+		row -= rowStep[dir];
+		col -= colStep[dir];
+		along--;
+	}
+	int rest = length - along;
+	//The old number has to keep at least one arrow, splitting its only arm at its first square would leave it none
+	if (tiling[ownerRow][ownerCol] <= rest + 1) {
+		return false;
+	}
+	tiling[row][col] = (Cell)rest;
+	tiling[ownerRow][ownerCol] -= (Cell)(rest + 1);
+	return true;
+}
+
+//Makes a number with one arrow on an empty square that has nowhere to grow, by taking the end of an arm next to it
+// The arrow gets turned around to point away from the new number, the number it came from has to have one to spare.
+// returns: false if no arm next to it ends there or none of them can spare it
+bool Generator::takeArmEnd(int row, int col) {
+	int take[4];
+	int numTake = 0;
+	for (int dir = 0; dir < 4; dir++) {
+		int n = row + rowStep[dir];
+		int m = col + colStep[dir];
+		if (n < 0 || n >= numRows || m < 0 || m >= numCols || !isArrowCell(tiling[n][m])) {
+			continue;
+		}
+		int armDir = tiling[n][m] - ARROW_CELL;
+		int ownerRow, ownerCol;
+		findOwner(n, m, ownerRow, ownerCol);
+		if (armLength(n, m, armDir) == 0 && tiling[ownerRow][ownerCol] > 1) {
+			take[numTake++] = dir;
+		}
+	}
+	if (numTake == 0) {
+		return false;
+	}
+	int dir = take[random.below(numTake)];
+	int n = row + rowStep[dir];
+	int m = col + colStep[dir];
+	int ownerRow, ownerCol;
+	findOwner(n, m, ownerRow, ownerCol);
+	tiling[ownerRow][ownerCol]--;
+	tiling[n][m] = (Cell)(ARROW_CELL + dir);
+	tiling[row][col] = 1;
+	return true;
+}
+
+//Merges numbers into the arm of the number behind them for as long as the puzzle stays unique
+// A number can only be merged if all of its arrows carry straight on in the one direction, the number behind then
+// just owns its square and its arm too. Fewer numbers makes for a harder puzzle, a merge that goes past
+// highestRating gets put back same as one that isn't unique.
+void Generator::mergeNumbers() {
+	vector<int> tried;
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		vector<int> cells;
+		for (int cell = 0; cell < numRows * numCols; cell++) {
+			cells.push_back(cell);
+		}
+		shuffle(cells);
+		for (int i = 0; i < cells.size(); i++) {
+			int row = cells[i] / numCols;
+			int col = cells[i] % numCols;
+			if (!isClueCell(tiling[row][col]) || find(tried.begin(), tried.end(), cells[i]) != tried.end()) {
+				continue;
+			}
+			for (int dir = 0; dir < 4; dir++) {
+				int behindRow = row - rowStep[dir];
+				int behindCol = col - colStep[dir];
+				if (armLength(row, col, dir) != tiling[row][col] || behindRow < 0 || behindRow >= numRows ||
+					behindCol < 0 || behindCol >= numCols) {
+					continue;
+				}
+				Cell behind = tiling[behindRow][behindCol];
+				if (!isClueCell(behind) && behind != ARROW_CELL + dir) {
+					continue;
+				}
+				int ownerRow = behindRow;
+				int ownerCol = behindCol;
+				if (!isClueCell(behind)) {
+					findOwner(behindRow, behindCol, ownerRow, ownerCol);
+				}
+				Cell value = tiling[row][col];
+				tiling[row][col] = (Cell)(ARROW_CELL + dir);
+				tiling[ownerRow][ownerCol] += (Cell)(value + 1);
+				vector<int> differ;
+				double rated;
+				if (otherSolution(differ, rated) == 1 && rated <= highestRating) {
+					rating = rated;
+					merged = true;
+				}
+				else {
+					//Not unique any more (or too hard), put it back and don't bother with it again
+					tiling[ownerRow][ownerCol] -= (Cell)(value + 1);
+					tiling[row][col] = value;
+					tried.push_back(cells[i]);
+				}
+				break;
+			}
+		}
+	}
+}
+
+//Solves the puzzle the tiling's numbers make, up to two solutions
+// differ gets the squares (row * numCols + col) where a solution other than the tiling has a different arrow, rated
+// gets the puzzle's rating from the guesses the solve took (only means anything when it's unique).
+// returns: how many solutions there are, 1 means the tiling is the only one
+int Generator::otherSolution(vector<int> &differ, double &rated) const {
+	Cell** puzzle = newGrid(numRows, numCols);
+	for (int n = 0; n < numRows; n++) {
+		for (int m = 0; m < numCols; m++) {
+			if (isClueCell(tiling[n][m])) {
+				puzzle[n][m] = tiling[n][m];
+			}
+		}
+	}
+	Solver solver(puzzle, numRows, numCols);
+	solver.tableBytes = CHECK_TABLE_BYTES;
+	solver.solutionLimit = 2;
+	differ.clear();
+	int found = (int)solver.streamSolutions(puzzle, [&](Cell** solution) {
+		if (!differ.empty()) {
+			return;
+		}
+		for (int n = 0; n < numRows; n++) {
+			for (int m = 0; m < numCols; m++) {
+				if (solution[n][m] != tiling[n][m]) {
+					differ.push_back(n * numCols + m);
+				}
+			}
+		}
+	});
+	rated = solver.rating(solver.difficultyRate, 1);
+	deleteGrid(puzzle, numRows);
+	return found;
+}
+
+//Puts a list in a random order
+void Generator::shuffle(vector<int> &list) {
+	for (int i = (int)list.size() - 1; i > 0; i--) {
+		swap(list[i], list[random.below(i + 1)]);
+	}
+}
+
+//Hands over the solution generated for an index
+// Puzzles are only looked at once every index before theirs is in, in order, so the ones kept are always the first
+// count different puzzles by index.
+void PuzzleCollector::add(int index, Cell** solution, int rows, int cols) {
+	Cell** puzzle = NULL;
+	if (solution != NULL) {
+		puzzle = newGrid(rows, cols);
+		for (int n = 0; n < rows; n++) {
+			for (int m = 0; m < cols; m++) {
+				if (isClueCell(solution[n][m])) {
+					puzzle[n][m] = solution[n][m];
+				}
+			}
+		}
+	}
+	lock_guard<mutex> guard(lock);
+	waiting[index] = puzzle;
+	while (!full && !waiting.empty() && waiting.begin()->first == kept) {
+		Cell** ready = waiting.begin()->second;
+		waiting.erase(waiting.begin());
+		kept++;
+		//The generator gave up, the rest would just do the same so that's all we're getting
+		if (ready == NULL) {
+			full = true;
+			break;
+		}
+		uint64_t key = 0;
+		for (int n = 0; n < rows; n++) {
+			for (int m = 0; m < cols; m++) {
+				if (isClueCell(ready[n][m])) {
+					key ^= mix64(((uint64_t)n * MAX_BOARD_SIZE + m) * 256 + ready[n][m]);
+				}
+			}
+		}
+		if (!seen.insert(key).second) {
+			deleteGrid(ready, rows);
+			continue;
+		}
+		puzzles.push_back(ready);
+		if (puzzles.size() >= wanted) {
+			full = true;
+		}
+	}
+}
+
+//Makes count different puzzles on a pool of threads
+// Every worker runs its own generator and keeps taking the next index, reseeding to that index's stream of the seed
+// and handing what it makes to the collector until it's full. The only thing they share is the collector, so it
+// scales with the cores. A worker in the middle of a puzzle when the collector fills up just finishes and throws it away.
+// Small boards only have so many different puzzles, so indexes run out after lastIndex and whatever was found comes back.
+vector<Cell**> generatePuzzles(int rows, int cols, int count, uint64_t seed, double lowest, double highest, int threads) {
+	if (count <= 0) {
+		return vector<Cell**>();
+	}
+	WorkStealingPool workers(threads);
+	PuzzleCollector made(count);
+	made.lastIndex = count * 10 + 100;
+	for (int i = 0; i < workers.size(); i++) {
+		workers.submit([&made, rows, cols, seed, lowest, highest]() {
+			Generator generator(rows, cols, seed);
+			generator.lowestRating = lowest;
+			generator.highestRating = highest;
+			while (!made.full) {
+				int index = made.next++;
+				if (index >= made.lastIndex) {
+					break;
+				}
+				generator.reseed(seed, index);
+				Cell** solution = generator.generate();
+				made.add(index, solution, rows, cols);
+				if (solution == NULL) {
+					break;
+				}
+				deleteGrid(solution, rows);
+			}
+		});
+	}
+	workers.wait();
+
+	//Anything made past the last one kept
+	for (map<int, Cell**>::iterator it = made.waiting.begin(); it != made.waiting.end(); it++) {
+		if (it->second != NULL) {
+			deleteGrid(it->second, rows);
+		}
+	}
+	return made.puzzles;
+}
@@ -0,0 +1,115 @@
+//
+// Generator.h : Makes new puzzles by laying down a solution first and working the clues out from it
+//
+//  Solver::puzzleCreation guesses clues and searches after every one to see where they lead, most of its time goes on
+//  boards that turn out to have no solution at all. The generator goes the other way round. It tiles the board with a
+//  random solution straight off, every square a number or an arrow on one of a number's arms, and the numbers' values
+//  are just how many arrows they ended up with. So the clues always have at least that one solution.
+//  Then the clues get fixed up until that solution is the only one:
+//    - While there's another solution, a square where it differs gets turned into a number, splitting the arm it was on
+//    - Once it's unique, numbers sitting at the end of another number's arm get merged into it while it stays unique
+//  Every uniqueness check is a full solve anyway, so it rates the puzzle for free (Solver::rating). That's what
+//  aims it at a difficulty: merges that would make it too hard are passed over, and tilings that are already too
+//  hard after splitting, or still too easy once nothing more merges, get thrown out right there.
+//
+//  Each generator has its own seeded random numbers (see Random.h), so any number of them can run side by side and
+//  the same seed always makes the same puzzles, see generatePuzzles.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+#include "Grid.h"
+#include "Random.h"
+
+class Generator {
+public:
+	//Sets up a generator for puzzles rows by cols, seed starts off its random numbers
+	Generator(int rows, int cols, uint64_t seed);
+	~Generator();
+
+	//Splits a tiling can take before it gets thrown out for a new one
+	int maxSplits;
+
+	//How many tilings were thrown out so far
+	int restarts;
+
+	//How many tilings one generate can throw out before it gives up
+	int maxRestarts;
+
+	//Only puzzles rated in here (out of 10, see Solver::rating) get made, 0 to 10 takes anything
+	// Small boards never rate high, asking one for a rating it can't reach just runs generate out of restarts.
+	double lowestRating;
+	double highestRating;
+
+	//What the last puzzle made was rated
+	double rating;
+
+	//Makes a new puzzle with exactly one solution
+	// returns: the solution, numbers and arrows (the puzzle is just its numbers), deleteGrid it when done
+	//          NULL if maxRestarts tilings in a row got thrown out
+	Cell** generate();
+
+	//Starts the random numbers over, on stream of seed (see Random)
+	void reseed(uint64_t seed, uint64_t stream);
+
+private:
+	int numRows;
+	int numCols;
+
+	//The solution being worked on, numbers hold how many arrows they own
+	Cell** tiling;
+
+	//This generator's own random numbers, nothing is shared with any other generator
+	Random random;
+
+	bool tile();
+	void growNumber(int row, int col, int target);
+	void findOwner(int row, int col, int &ownerRow, int &ownerCol) const;
+	int armLength(int row, int col, int dir) const;
+	bool splitAt(int row, int col);
+	bool takeArmEnd(int row, int col);
+	void mergeNumbers();
+	int otherSolution(std::vector<int> &differ, double &rated) const;
+	void shuffle(std::vector<int> &list);
+};
+
+//Gathers what the workers of a parallel generate make, see generatePuzzles
+// Every puzzle gets an index and is made from its own stream of the seed. They are kept in index order, so which
+// ones make it in doesn't depend on which thread finished first.
+struct PuzzleCollector {
+	std::mutex lock;
+	std::vector<Cell**> puzzles;
+
+	//Next index to hand out (none past lastIndex), and puzzles finished ahead of one before them that isn't done yet
+	std::atomic<int> next;
+	int lastIndex;
+	std::map<int, Cell**> waiting;
+	int kept;
+
+	//Hashes of the clues of every puzzle kept so far, so the same one twice only counts once
+	std::unordered_set<uint64_t> seen;
+
+	//How many puzzles are wanted, full gets raised for every worker once there are that many
+	size_t wanted;
+	std::atomic<bool> full;
+
+	PuzzleCollector(size_t count) : next(0), lastIndex(0), kept(0), wanted(count), full(false) {}
+
+	//Hands over the solution generated for an index, it's kept as a puzzle (its numbers) unless the same one already was
+	// A NULL solution (the generator gave up) ends the collecting at that index.
+	void add(int index, Cell** solution, int rows, int cols);
+};
+
+//Makes count different puzzles rows by cols from seed, with a generator working on each of threads threads (0 for one per core)
+// Every puzzle is rated from lowest to highest (see Generator::lowestRating). The same seed gives back the same puzzles
+// in the same order, however many threads there are.
+// returns: the puzzles (numbers only), deleteGrid each one when done. Fewer than count if there weren't that many different
+//          ones to be found, or the generators gave up (see Generator::generate).
+std::vector<Cell**> generatePuzzles(int rows, int cols, int count, uint64_t seed, double lowest, double highest,
+	int threads = 0);
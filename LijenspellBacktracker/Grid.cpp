@@ -0,0 +1,186 @@
+//
+// Grid.cpp : Puzzle grids and the text format they are read from and written to
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <ctype.h> //isdigit
+#include <stdio.h> //sscanf
+#include "Grid.h"
+using namespace std;
+
+//A new grid, every square BLANK
+Cell** newGrid(int rows, int cols) {
+	Cell** grid = new Cell *[rows];
+	for (int n = 0; n < rows; n++) {
+		grid[n] = new Cell[cols];
+		for (int m = 0; m < cols; m++) {
+			grid[n][m] = BLANK;
+		}
+	}
+	return grid;
+}
+
+//Deletes a grid
+void deleteGrid(Cell** grid, int rows) {
+	for (int n = 0; n < rows; n++) {
+		delete[]grid[n];
+	}
+	delete[]grid;
+}
+
+//Turns the text for one square into a cell
+// returns: false if it isn't x, an arrow or a clue we can hold
+static bool parseCell(const string &text, Cell &square) {
+	if (text == "x" || text == "X") {
+		square = BLANK;
+		return true;
+	}
+	for (int dir = 0; dir < 4; dir++) {
+		if (text.size() == 1 && text[0] == arrows[dir]) {
+			square = (Cell)(ARROW_CELL + dir);
+			return true;
+		}
+	}
+	int value = 0;
+	for (size_t i = 0; i < text.size(); i++) {
+		if (!isdigit((unsigned char)text[i]) || value > MAX_CLUE) {
+			return false;
+		}
+		value = value * 10 + (text[i] - '0');
+	}
+	if (text.empty() || value < 1 || value > MAX_CLUE) {
+		return false;
+	}
+	square = (Cell)value;
+	return true;
+}
+
+//Splits a row of text into the text of its squares
+static void splitRow(const string &line, vector<string> &squares) {
+	squares.clear();
+	//Whitespace left on the end (or a \r from windows) doesn't make it the new way, old files are full of it
+	size_t length = line.find_last_not_of(" \t\r") + 1;
+	if (line.find_first_of(" ,\t") >= length) {
+		//The old way, a character a square
+		for (size_t i = 0; i < length; i++) {
+			squares.push_back(string(1, line[i]));
+		}
+		return;
+	}
+	string text;
+	for (size_t i = 0; i <= line.size(); i++) {
+		if (i == line.size() || line[i] == ' ' || line[i] == ',' || line[i] == '\t') {
+			if (!text.empty()) {
+				squares.push_back(text);
+				text.clear();
+			}
+		}
+		else {
+			text += line[i];
+		}
+	}
+}
+
+//Reads a grid in the text format
+bool readGrid(istream &in, Cell** &grid, int &rows, int &cols) {
+	//First line must be ROW COL
+	string line;
+	if (!getline(in, line) || sscanf(line.c_str(), "%d %d", &rows, &cols) != 2 || rows < 1 || cols < 1) {
+		return false;
+	}
+	grid = newGrid(rows, cols);
+	vector<string> squares;
+	for (int n = 0; n < rows; n++) {
+		if (!getline(in, line)) {
+			deleteGrid(grid, rows);
+			return false;
+		}
+		//Files saved on windows
+		if (!line.empty() && line[line.size() - 1] == '\r') {
+			line.erase(line.size() - 1);
+		}
+		splitRow(line, squares);
+		if ((int)squares.size() < cols) {
+			deleteGrid(grid, rows);
+			return false;
+		}
+		for (int m = 0; m < cols; m++) {
+			if (!parseCell(squares[m], grid[n][m])) {
+				deleteGrid(grid, rows);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//Writes a grid in the text format
+void writeGrid(ostream &out, Cell** grid, int rows, int cols, bool keepArrows) {
+	//Single digit clues can go out the old way
+	bool compact = true;
+	for (int n = 0; n < rows; n++) {
+		for (int m = 0; m < cols; m++) {
+			if (isClueCell(grid[n][m]) && grid[n][m] > 9) {
+				compact = false;
+			}
+		}
+	}
+	out << rows << " " << cols << "\n";
+	for (int n = 0; n < rows; n++) {
+		for (int m = 0; m < cols; m++) {
+			if (m > 0 && !compact) {
+				out << " ";
+			}
+			if (grid[n][m] == BLANK || (isArrowCell(grid[n][m]) && !keepArrows)) {
+				out << 'x';
+			}
+			else {
+				out << cellText(grid[n][m]);
+			}
+		}
+		out << endl;
+	}
+}
+
+//Writes a solved grid on one line
+void writeSolutionLine(ostream &out, Cell** grid, int rows, int cols) {
+	string line;
+	line.reserve(rows * cols + 1);
+	for (int n = 0; n < rows; n++) {
+		for (int m = 0; m < cols; m++) {
+			if (isArrowCell(grid[n][m])) {
+				line += arrows[grid[n][m] - ARROW_CELL];
+			}
+			else {
+				line += grid[n][m] == BLANK ? 'x' : '#';
+			}
+		}
+	}
+	line += '\n';
+	out << line;
+}
+
+//How a square looks printed
+string cellText(Cell square) {
+	if (square == BLANK) {
+		return " ";
+	}
+	if (isArrowCell(square)) {
+		return string(1, arrows[square - ARROW_CELL]);
+	}
+	return to_string((int)square);
+}
+
+//Widest cellText of any square on a grid
+int cellWidth(Cell** grid, int rows, int cols) {
+	int width = 1;
+	for (int n = 0; n < rows; n++) {
+		for (int m = 0; m < cols; m++) {
+			if (isClueCell(grid[n][m]) && (int)cellText(grid[n][m]).size() > width) {
+				width = (int)cellText(grid[n][m]).size();
+			}
+		}
+	}
+	return width;
+}
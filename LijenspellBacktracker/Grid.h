@@ -0,0 +1,61 @@
+//
+// Grid.h : Puzzle grids and the text format they are read from and written to
+//
+//  A grid is an array of rows with one byte per square. A square holds a clue (1 up to MAX_CLUE), BLANK, or an arrow
+//  (ARROW_CELL + its direction). Clues only ever need to go as high as a number could reach, (rows - 1) + (cols - 1),
+//  which is 126 on the biggest board, so a byte leaves plenty of room.
+//
+//  Text format: the first line is ROWS COLS, then a line for every row with its squares separated by spaces or commas
+//      x 12 x > 3
+//  x is an empty square, ^ > v < are arrows and numbers are clues. A row with no separators in it gets read a character
+//  at a time the old way (x3xx2), so single digit puzzles don't have to change. Grids are written the old way too
+//  when every clue is a single digit.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+
+//One square of a grid
+typedef uint8_t Cell;
+
+const Cell BLANK = 0;
+//ARROW_CELL + dir is an arrow pointing in dir (UP, RIGHT, DOWN, LEFT), everything from 1 up to below it is a clue
+const Cell ARROW_CELL = 252;
+const int MAX_CLUE = ARROW_CELL - 1;
+
+//Nice list of the arrow characters
+const char arrows[4] = {'^', '>', 'v', '<'};
+
+inline bool isArrowCell(Cell square) {
+	return square >= ARROW_CELL;
+}
+
+inline bool isClueCell(Cell square) {
+	return square != BLANK && square < ARROW_CELL;
+}
+
+//A new grid, every square BLANK
+Cell** newGrid(int rows, int cols);
+
+//Deletes a grid made by newGrid (or any grid with its rows made by new[])
+void deleteGrid(Cell** grid, int rows);
+
+//Reads a grid in the text format, false (and no grid) if it isn't one
+bool readGrid(std::istream &in, Cell** &grid, int &rows, int &cols);
+
+//Writes a grid in the text format, with arrows left out (as x) unless keepArrows is set
+void writeGrid(std::ostream &out, Cell** grid, int rows, int cols, bool keepArrows);
+
+//Writes a solved grid on one line, a character a square going along each row in turn. Arrows are themselves and
+// numbers are #, whoever reads it already has the puzzle, so streams of solutions stay a byte a square
+void writeSolutionLine(std::ostream &out, Cell** grid, int rows, int cols);
+
+//How a square looks printed, a blank square is a space
+std::string cellText(Cell square);
+
+//Widest cellText of any square on a grid, for lining up columns
+int cellWidth(Cell** grid, int rows, int cols);
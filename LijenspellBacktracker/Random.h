@@ -0,0 +1,58 @@
+//
+// Random.h : Seeded random numbers for puzzle creation and the generator
+//
+//  xoshiro256** (Blackman and Vigna), seeded through splitmix64. Every random choice creation makes comes from one of
+//  these, so the same seed always makes the same choices on every platform, and the same search tree gets explored.
+//  That's what makes timing a change to creation (or chasing down a run that took minutes) possible at all.
+//  rand() gave different numbers on every compiler and was one bit of shared state for the whole process.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+class Random {
+public:
+	//Starts the numbers off from a seed, stream picks one of many separate sequences for the same seed
+	// (each puzzle of a parallel generate gets its own, see generatePuzzles)
+	explicit Random(uint64_t seed, uint64_t stream = 0) {
+		uint64_t x = seed ^ splitmix(stream);
+		for (int i = 0; i < 4; i++) {
+			x += 0x9E3779B97F4A7C15ULL;
+			state[i] = splitmix(x);
+		}
+	}
+
+	//Next 64 random bits
+	uint64_t next() {
+		uint64_t result = rotate(state[1] * 5, 7) * 9;
+		uint64_t t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotate(state[3], 45);
+		return result;
+	}
+
+	//A random number from 0 up to n - 1, scaled off the top bits instead of % so it comes out the same everywhere
+	int below(int n) {
+		return (int)(((next() >> 32) * (uint64_t)n) >> 32);
+	}
+
+private:
+	uint64_t state[4];
+
+	static uint64_t rotate(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+	//The splitmix64 finalizer, spreads a seed out over all 64 bits
+	static uint64_t splitmix(uint64_t x) {
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+};
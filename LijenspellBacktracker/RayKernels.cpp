@@ -0,0 +1,111 @@
+//
+// RayKernels.cpp : Batched ray scans for the Lijenspel backtracker
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RayKernels.h"
+
+#if !defined(NO_SIMD_RAYS) && defined(__AVX2__)
+#define AVX2_RAYS
+#include <immintrin.h>
+#elif !defined(NO_SIMD_RAYS) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SSE2_RAYS
+#include <emmintrin.h>
+#endif
+
+//Run towards the high bits: fill in everything behind the ray, then adding one carries up through the run and stops
+// on the first blocker, so the bits the carry flipped that were set are the run.
+static inline uint64_t runTowardsHigh(uint64_t line, uint64_t behind) {
+	uint64_t filled = line | behind;
+	return ((filled + 1) ^ filled) & filled & ~behind;
+}
+
+//Run towards the low bits: smear every blocker in front of the ray down to bit 0, what is left in front is the run
+static inline uint64_t runTowardsLow(uint64_t line, uint64_t behind) {
+	uint64_t blockers = ~line & ~behind;
+	blockers |= blockers >> 1;
+	blockers |= blockers >> 2;
+	blockers |= blockers >> 4;
+	blockers |= blockers >> 8;
+	blockers |= blockers >> 16;
+	blockers |= blockers >> 32;
+	return ~behind & ~blockers;
+}
+
+#ifdef AVX2_RAYS
+
+//Same as the plain versions, a whole square's four rays at a time. Both runs get worked out in every lane and the
+// direction of each lane picks which one it keeps.
+void rayRuns(const uint64_t* lines, const uint64_t* behind, uint64_t* runs, int squares) {
+	const __m256i one = _mm256_set1_epi64x(1);
+	const __m256i high = _mm256_set_epi64x(0, -1, -1, 0);
+	for (int s = 0; s < squares; s++) {
+		__m256i line = _mm256_loadu_si256((const __m256i*)(lines + s * 4));
+		__m256i back = _mm256_loadu_si256((const __m256i*)(behind + s * 4));
+
+		__m256i filled = _mm256_or_si256(line, back);
+		__m256i up = _mm256_andnot_si256(back, _mm256_and_si256(_mm256_xor_si256(_mm256_add_epi64(filled, one), filled), filled));
+
+		__m256i front = _mm256_andnot_si256(back, _mm256_set1_epi64x(-1));
+		__m256i blockers = _mm256_andnot_si256(line, front);
+		blockers = _mm256_or_si256(blockers, _mm256_srli_epi64(blockers, 1));
+		blockers = _mm256_or_si256(blockers, _mm256_srli_epi64(blockers, 2));
+		blockers = _mm256_or_si256(blockers, _mm256_srli_epi64(blockers, 4));
+		blockers = _mm256_or_si256(blockers, _mm256_srli_epi64(blockers, 8));
+		blockers = _mm256_or_si256(blockers, _mm256_srli_epi64(blockers, 16));
+		blockers = _mm256_or_si256(blockers, _mm256_srli_epi64(blockers, 32));
+		__m256i down = _mm256_andnot_si256(blockers, front);
+
+		__m256i run = _mm256_or_si256(_mm256_and_si256(high, up), _mm256_andnot_si256(high, down));
+		_mm256_storeu_si256((__m256i*)(runs + s * 4), run);
+	}
+}
+
+#elif defined(SSE2_RAYS)
+
+//Same as the plain versions, two rays at a time so a square is two goes, (UP, RIGHT) then (DOWN, LEFT).
+// Both runs get worked out in every lane and the direction of each lane picks which one it keeps.
+void rayRuns(const uint64_t* lines, const uint64_t* behind, uint64_t* runs, int squares) {
+	const __m128i one = _mm_set_epi32(0, 1, 0, 1);
+	const __m128i ones = _mm_set1_epi32(-1);
+	//The second lane of both halves (RIGHT and LEFT) is the odd one out, so the mask flips between them
+	const __m128i highFirst = _mm_set_epi32(-1, -1, 0, 0);
+	const __m128i highSecond = _mm_set_epi32(0, 0, -1, -1);
+	for (int i = 0; i < squares * 2; i++) {
+		__m128i line = _mm_loadu_si128((const __m128i*)(lines + i * 2));
+		__m128i back = _mm_loadu_si128((const __m128i*)(behind + i * 2));
+		__m128i high = (i & 1) ? highSecond : highFirst;
+
+		__m128i filled = _mm_or_si128(line, back);
+		__m128i up = _mm_andnot_si128(back, _mm_and_si128(_mm_xor_si128(_mm_add_epi64(filled, one), filled), filled));
+
+		__m128i front = _mm_andnot_si128(back, ones);
+		__m128i blockers = _mm_andnot_si128(line, front);
+		blockers = _mm_or_si128(blockers, _mm_srli_epi64(blockers, 1));
+		blockers = _mm_or_si128(blockers, _mm_srli_epi64(blockers, 2));
+		blockers = _mm_or_si128(blockers, _mm_srli_epi64(blockers, 4));
+		blockers = _mm_or_si128(blockers, _mm_srli_epi64(blockers, 8));
+		blockers = _mm_or_si128(blockers, _mm_srli_epi64(blockers, 16));
+		blockers = _mm_or_si128(blockers, _mm_srli_epi64(blockers, 32));
+		__m128i down = _mm_andnot_si128(blockers, front);
+
+		__m128i run = _mm_or_si128(_mm_and_si128(high, up), _mm_andnot_si128(high, down));
+		_mm_storeu_si128((__m128i*)(runs + i * 2), run);
+	}
+}
+
+#else
+
+//Plain version, one ray at a time
+void rayRuns(const uint64_t* lines, const uint64_t* behind, uint64_t* runs, int squares) {
+	for (int i = 0; i < squares * 4; i++) {
+		if (towardsHigh(i % 4)) {
+			runs[i] = runTowardsHigh(lines[i], behind[i]);
+		}
+		else {
+			runs[i] = runTowardsLow(lines[i], behind[i]);
+		}
+	}
+}
+
+#endif
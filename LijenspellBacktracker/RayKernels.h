@@ -0,0 +1,26 @@
+//
+// RayKernels.h : Batched ray scans for the Lijenspel backtracker
+//
+//  Nearly everything the solver and puzzle creation ask about a number is "how far does the run of some kind of square
+//  go from here in each direction", the same ray walk done four times per number. These kernels do a whole batch of
+//  squares at once, all four directions together, using AVX2 or SSE2 when the compiler has them and plain words otherwise.
+//  Vertical rays read the transposed column words of the Bitboard so every ray is a single contiguous word.
+//
+//  No bit scans are needed: a run towards the high bits falls out of a carry, a run towards the low bits out of
+//  smearing the first blocker down, so each lane does the same handful of shifts, adds and masks.
+//  Define NO_SIMD_RAYS to always use the plain version.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Bitboard.h"
+
+//Most squares handed to rayRuns in one go by the solver, so its scratch space can sit on the stack
+const int RAY_BATCH = 16;
+
+//Runs of set bits along a batch of rays, four rays a square in direction order (UP, RIGHT, DOWN, LEFT)
+// lines: the word each ray travels along
+// behind: the square each ray starts from and everything behind it, upToAlongRay(pos, dir)
+// runs gets the same as rayRun would give for each ray
+void rayRuns(const uint64_t* lines, const uint64_t* behind, uint64_t* runs, int squares);
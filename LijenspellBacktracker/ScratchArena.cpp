@@ -0,0 +1,60 @@
+//
+// ScratchArena.cpp : Stack of scratch space for the backtracker's nodes
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ScratchArena.h"
+using namespace std;
+
+//Smallest block we bother getting, in words
+static const size_t MIN_BLOCK_WORDS = 4096;
+
+//Starts out with nothing, the first take gets the first block
+ScratchArena::ScratchArena() : block(0), used(0) {
+}
+
+//A copy starts out empty
+ScratchArena::ScratchArena(const ScratchArena &) : block(0), used(0) {
+}
+
+//Keeps our own blocks, just empties them
+ScratchArena& ScratchArena::operator=(const ScratchArena &) {
+	block = 0;
+	used = 0;
+	return *this;
+}
+
+//Where the top is now
+ArenaMark ScratchArena::mark() const {
+	ArenaMark here;
+	here.block = block;
+	here.used = used;
+	return here;
+}
+
+//Gives up everything taken since mark
+void ScratchArena::release(const ArenaMark &mark) {
+	block = mark.block;
+	used = mark.used;
+}
+
+//Room for some words off the top, moving on to the next block (or getting a new one) when this one is full
+uint64_t* ScratchArena::takeWords(size_t words) {
+	while (block < blocks.size() && used + words > sizes[block]) {
+		block++;
+		used = 0;
+	}
+	if (block == blocks.size()) {
+		//Double up each time so a deep search only needs a handful of blocks
+		size_t size = sizes.empty() ? MIN_BLOCK_WORDS : sizes.back() * 2;
+		if (size < words) {
+			size = words;
+		}
+		blocks.push_back(unique_ptr<uint64_t[]>(new uint64_t[size]));
+		sizes.push_back(size);
+		used = 0;
+	}
+	uint64_t* space = blocks[block].get() + used;
+	used += words;
+	return space;
+}
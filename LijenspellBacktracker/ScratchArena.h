@@ -0,0 +1,55 @@
+//
+// ScratchArena.h : Stack of scratch space for the backtracker's nodes
+//
+//  Every node of the search (and every step of puzzle creation) needs a few buffers that only live until it returns.
+//  Instead of new[] and delete[] for each one, a node marks the top of the arena, takes what it needs off the top and
+//  releases back to its mark when it is done, so the arena is a stack with one frame per level of the search.
+//  Memory comes in blocks that are kept once the search has gone that deep, after the first few nodes no buffer
+//  costs a heap call, and putting the top back at the end of a solve gives up every frame at once.
+//
+//  Blocks never move, so a frame's buffers stay put while the nodes under it take theirs.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <memory>
+
+//Where the top of an arena was, see ScratchArena::mark
+struct ArenaMark {
+	size_t block, used;
+};
+
+class ScratchArena {
+public:
+	ScratchArena();
+
+	//A copy starts out empty, scratch space is never shared
+	ScratchArena(const ScratchArena &other);
+	ScratchArena& operator=(const ScratchArena &other);
+
+	//Where the top is now, releasing back to it gives up everything taken since
+	ArenaMark mark() const;
+
+	//Gives up everything taken since mark, the memory stays around for the next frame
+	void release(const ArenaMark &mark);
+
+	//Room for count things of type T off the top of the arena, not cleared
+	template <typename T>
+	T* take(size_t count) {
+		return (T*)takeWords((count * sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	}
+
+private:
+	std::vector<std::unique_ptr<uint64_t[]>> blocks;
+	std::vector<size_t> sizes;
+
+	//Block the top is in and how many words of it are taken
+	size_t block;
+	size_t used;
+
+	uint64_t* takeWords(size_t words);
+};
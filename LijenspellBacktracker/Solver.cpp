@@ -0,0 +1,1791 @@
+//
+// Solver.cpp : The backtracker and puzzle creation, working on the state held in a Solver
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream> //Lots of IO
+#include <iomanip> //setw
+#include <algorithm>
+#include <stdlib.h> //system
+#include <string.h> //memcpy
+#include <math.h> //pow
+#include "Solver.h"
+using namespace std;
+
+//Will sort our numbers for us :)
+//params: the two number structs to sort
+static int numbersSorter(number num1, number num2) {
+	return (num1.value < num2.value);
+}
+
+//Sets up a solver for a puzzle grid of spaces, numbers and arrows
+Solver::Solver(Cell** puzzle, int rows, int cols) {
+	numRows = rows;
+	numCols = cols;
+	numNumbers = 0;
+	numUnfinished = 0;
+	currentNumber = 0;
+	mode = 1;
+	difficultyRate = 0;
+	lowestRating = 0;
+	highestRating = 10;
+	maxCreationSolves = 2000000;
+	creationSolves = 0;
+	branching = PLACEMENT_BRANCHING;
+	tableBytes = 4 * 1024 * 1024;
+	hash = 0;
+	handOffs = 0;
+	partials = NULL;
+	regionMark = 0;
+	parentReach = NULL;
+	pool = NULL;
+	collector = NULL;
+	solutionLimit = 0;
+	stopped = false;
+	seed = 0;
+	countOnly = false;
+	hashSolutions = false;
+	solutionCount = 0;
+	solutionHash = 0;
+	sink = NULL;
+	sinkGrid = NULL;
+
+	//Anything that isn't blank or an arrow is a number
+	for (int n = 0; n < numRows; n++) {
+		for (int m = 0; m < numCols; m++) {
+			if (isClueCell(puzzle[n][m])) {
+				number num;
+				num.row = n;
+				num.col = m;
+				num.value = puzzle[n][m];
+				num.remaining = num.value;
+				numbers.push_back(num);
+				numNumbers++;
+			}
+		}
+	}
+
+	//Sort array of numbers so that we can just do them in order
+	sort(numbers.begin(), numbers.end(), numbersSorter);
+}
+
+//An arrow in dir on (row, col) just went down (change -1) or is coming back up (change +1)
+// Finds the number whose chain it is part of and moves its remaining, so we never have to rescan for it.
+void Solver::arrowChanged(int row, int col, int dir, int change) {
+	//Walk back over the arrows behind this square to see if there is a number at the end
+	int back = (dir + 2) % 4;
+	int behind = popCount(rayRun(board.line(dir, row, col, dir), Bitboard::linePos(row, col, dir), back));
+	int ownerRow, ownerCol;
+	if (!board.step(row, col, back, behind + 1, ownerRow, ownerCol)) {
+		return;
+	}
+	int owner = numberAt[ownerRow][ownerCol];
+	if (owner == -1) {
+		return;
+	}
+	//Loose arrows already sitting past this square get joined up to the chain too
+	int joined = 1 + board.ownRun(row, col, dir);
+	if (numbers[owner].remaining == 0) {
+		numUnfinished++;
+	}
+	numbers[owner].remaining += change * joined;
+	if (numbers[owner].remaining == 0) {
+		numUnfinished--;
+	}
+}
+
+//Fills a square on the shared board and remembers it on the trail
+void Solver::placeArrow(int row, int col, int dir) {
+	board.set(row, col, dir);
+	hash ^= zobristKey(row, col, dir);
+	trail.push_back(row * MAX_BOARD_SIZE + col);
+	arrowChanged(row, col, dir, -1);
+	//Numbers looking along this row or column have to prune again
+	for (int i = 0; i < rowNumbers[row].size(); i++) {
+		dirty[rowNumbers[row][i]] = 1;
+	}
+	for (int i = 0; i < colNumbers[col].size(); i++) {
+		dirty[colNumbers[col][i]] = 1;
+	}
+}
+
+//Empties every square filled since the trail was mark long
+void Solver::undoTo(size_t mark) {
+	while (trail.size() > mark) {
+		int cell = trail.back();
+		trail.pop_back();
+		int row = cell / MAX_BOARD_SIZE;
+		int col = cell % MAX_BOARD_SIZE;
+		int dir = board.get(row, col);
+		board.set(row, col, EMPTY);
+		hash ^= zobristKey(row, col, dir);
+		arrowChanged(row, col, dir, 1);
+	}
+}
+
+//Grows every domain back to how it was when the domain trail was mark long
+void Solver::undoDomainsTo(size_t mark) {
+	while (domainTrail.size() > mark) {
+		domainSize[domainTrail.back().first] = domainTrail.back().second;
+		domainTrail.pop_back();
+	}
+}
+
+//Rates a puzzle from the guesses it took to solve, bigger boards and fewer solutions make the same guesses harder
+// returns: 1 up to 10, 10 being extremely hard
+double Solver::rating(double guesses, size_t numSolutions) const {
+	double rated = ((5 * (pow(guesses, 0.25) / 4) * (numRows / 6.0) * (numCols / 6.0)) / numSolutions) + 1;
+	if (rated > 10) {
+		//Just a catch for the crazy hard ones that disobey scaling
+		rated = 10;
+	}
+	return rated;
+}
+
+//Prints a single representation of the puzzle
+void Solver::printPuzzle(Cell** puzzle) const {
+	//Every square gets as wide as the widest clue
+	int width = cellWidth(puzzle, numRows, numCols);
+
+	//Print top
+	for (int n = 0; n < numCols; n++) {
+		cout << string(width + 3, '_');
+	}
+	cout << endl;
+
+	//Print grid
+	for (int n = 0; n < numRows; n++) {
+		cout << "| ";
+		for (int m = 0; m < numCols; m++) {
+			cout << setw(width) << cellText(puzzle[n][m]) << " | ";
+		}
+		cout << endl;
+		for (int n = 0; n < numCols; n++) {
+			cout << "|" << string(width + 2, '_');
+		}
+		cout << "|" << endl;
+	}
+	cout << endl;
+}
+
+//Builds the bitboard for a puzzle grid
+// param puzzle: Grid of spaces, numbers and arrows
+Bitboard Solver::loadBitboard(Cell** puzzle) const {
+	Bitboard state;
+	state.reset(numRows, numCols);
+	for (int n = 0; n < numRows; n++) {
+		for (int m = 0; m < numCols; m++) {
+			if (puzzle[n][m] == BLANK) {
+				continue;
+			}
+			state.set(n, m, isArrowCell(puzzle[n][m]) ? puzzle[n][m] - ARROW_CELL : NUMBER);
+		}
+	}
+	return state;
+}
+
+//Zobrist hash of every arrow on a state, placeArrow and undoTo keep it up to date from here
+uint64_t Solver::hashArrows(const Bitboard &state) const {
+	uint64_t key = 0;
+	for (int dir = 0; dir < 4; dir++) {
+		for (int n = 0; n < numRows; n++) {
+			uint64_t cells = state.rowBits[dir][n];
+			while (cells != 0) {
+				key ^= zobristKey(n, lowestBit(cells), dir);
+				cells &= cells - 1;
+			}
+		}
+	}
+	return key;
+}
+
+//The grid for the board as it is right now
+Cell** Solver::currentPuzzle() const {
+	return toPuzzle(board);
+}
+
+//Turns a bitboard back into a grid we can print and save, number values come from the numbers list
+Cell** Solver::toPuzzle(const Bitboard &state) const {
+	Cell** puzzle = newGrid(numRows, numCols);
+	fillPuzzle(state, puzzle);
+	return puzzle;
+}
+
+//Writes a bitboard over a grid we already have, every square gets set
+void Solver::fillPuzzle(const Bitboard &state, Cell** puzzle) const {
+	for (int n = 0; n < numRows; n++) {
+		for (int m = 0; m < numCols; m++) {
+			int cell = state.get(n, m);
+			puzzle[n][m] = cell < 4 ? (Cell)(ARROW_CELL + cell) : BLANK;
+		}
+	}
+	for (int i = 0; i < numNumbers; i++) {
+		puzzle[numbers[i].row][numbers[i].col] = (Cell)numbers[i].value;
+	}
+}
+
+//Checks if you have a solution to the puzzle
+// param board: The puzzle state to check for a solution
+bool Solver::isSolved(const Bitboard &state) const {
+	//Check all our numbers have their arrows
+	if (numUnfinished != 0) {
+		return false;
+	}
+	//Check all squares are filled
+	if (!state.isFull()) {
+		return false;
+	}
+	//Every arrow has to belong to a number, so the numbers have to add up to all the squares that aren't one
+	int total = 0;
+	for (int i = 0; i < numNumbers; i++) {
+		total += numbers[i].value;
+	}
+	return total == numRows * numCols - numNumbers;
+}
+
+//Checks if we are still working on a good puzzle
+//Pruning techniques:
+//	Make sure every number has space to expand to their needed size
+//  Make sure every empty square can be reached
+bool Solver::isValid(const Bitboard &state) const {
+	//First Check Each Number Can Expand
+	int batch[RAY_BATCH];
+	uint64_t open[RAY_BATCH * 4];
+	uint64_t own[RAY_BATCH * 4];
+	for (int start = 0; start < numNumbers; start += RAY_BATCH) {
+		int count = min(RAY_BATCH, numNumbers - start);
+		for (int i = 0; i < count; i++) {
+			batch[i] = start + i;
+		}
+		numberRays(state, batch, count, false, open);
+		numberRays(state, batch, count, true, own);
+		for (int i = 0; i < count; i++) {
+			//Count the squares we could still take along each ray, our own arrows don't block
+			int curRemain = numbers[start + i].remaining;
+			for (int dir = 0; dir < 4; dir++) {
+				curRemain -= popCount(open[i * 4 + dir] & ~own[i * 4 + dir]);
+			}
+			//Did it have space?
+			if (curRemain > 0) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+//Works out every number's remaining from scratch when we start on a board
+// After this placeArrow and undoTo keep them up to date as the backtracker goes.
+void Solver::updateRemaining(const Bitboard &state) {
+	//Sort on value, which never changes during a solve so the order only has to be set up here
+	sort(numbers.begin(), numbers.end(), numbersSorter);
+
+	for (int n = 0; n < numRows; n++) {
+		for (int m = 0; m < numCols; m++) {
+			numberAt[n][m] = -1;
+		}
+	}
+
+	rowNumbers.assign(numRows, vector<int>());
+	colNumbers.assign(numCols, vector<int>());
+	rayStart.resize(numNumbers * 4);
+	for (int i = 0; i < numNumbers; i++) {
+		for (int dir = 0; dir < 4; dir++) {
+			rayStart[i * 4 + dir] = upToAlongRay(Bitboard::linePos(numbers[i].row, numbers[i].col, dir), dir);
+		}
+		numberAt[numbers[i].row][numbers[i].col] = i;
+		rowNumbers[numbers[i].row].push_back(i);
+		colNumbers[numbers[i].col].push_back(i);
+	}
+
+	//Loops through numbers and changes their remaining based on the arrows they are connnect to
+	numUnfinished = 0;
+	int batch[RAY_BATCH];
+	uint64_t own[RAY_BATCH * 4];
+	for (int start = 0; start < numNumbers; start += RAY_BATCH) {
+		int count = min(RAY_BATCH, numNumbers - start);
+		for (int i = 0; i < count; i++) {
+			batch[i] = start + i;
+		}
+		numberRays(state, batch, count, true, own);
+		for (int i = 0; i < count; i++) {
+			number &num = numbers[start + i];
+			int found = 0;
+			for (int dir = 0; dir < 4; dir++) {
+				found += popCount(own[i * 4 + dir]);
+			}
+			//Update remaining
+			num.remaining = num.value - found;
+			if (num.remaining != 0) {
+				numUnfinished++;
+			}
+		}
+	}
+
+}
+
+//Runs along the four rays of each listed number, runs[i * 4 + dir] for number which[i], at most RAY_BATCH numbers
+// own: just the number's own arrows chained onto it (Bitboard::ownRay), otherwise every square it could extend through (Bitboard::openRay)
+void Solver::numberRays(const Bitboard &state, const int* which, int count, bool own, uint64_t* runs) const {
+	uint64_t lines[RAY_BATCH * 4];
+	uint64_t start[RAY_BATCH * 4];
+	for (int i = 0; i < count; i++) {
+		const number &num = numbers[which[i]];
+		for (int dir = 0; dir < 4; dir++) {
+			uint64_t line = state.line(dir, num.row, num.col, dir);
+			if (!own) {
+				line |= state.line(EMPTY, num.row, num.col, dir);
+			}
+			lines[i * 4 + dir] = line;
+			start[i * 4 + dir] = rayStart[which[i] * 4 + dir];
+		}
+	}
+	rayRuns(lines, start, runs, count);
+}
+
+//Throws out every placement the board has ruled out, a placement can only run over empty squares and its own
+// arrows and it has to take in all of its own arrows.
+// Only numbers marked dirty (a square changed in their row or column) get looked at, unless all is set.
+// reach gets the empty squares each number could still take, [k * 2] in its row word and [k * 2 + 1] in its column word,
+// numbers that aren't looked at keep the reach they already had in there
+// covered gets (per row) the squares at least one number reaches and shared the squares more than one number reaches
+// returns: false if a number has no placements left
+bool Solver::pruneDomains(uint64_t* reach, uint64_t* covered, uint64_t* shared, bool all) {
+	//Open rays for the numbers that need looking at, a batch at a time
+	int batch[RAY_BATCH];
+	uint64_t open[RAY_BATCH * 4];
+	int next = 0;
+	while (next < numNumbers) {
+		int count = 0;
+		for (; next < numNumbers && count < RAY_BATCH; next++) {
+			if (all || dirty[next]) {
+				batch[count++] = next;
+			}
+		}
+		numberRays(board, batch, count, false, open);
+
+		for (int i = 0; i < count; i++) {
+			int k = batch[i];
+			int curRow = numbers[k].row;
+			int curCol = numbers[k].col;
+			uint64_t blocked[2] = {0, 0};
+			uint64_t needed[2] = {0, 0};
+			for (int dir = 0; dir < 4; dir++) {
+				int word = horizontal(dir) ? 0 : 1;
+				blocked[word] |= ~rayStart[k * 4 + dir] & ~open[i * 4 + dir];
+				needed[word] |= open[i * 4 + dir] & board.line(dir, curRow, curCol, dir);
+			}
+			if (!pruneDomain(k, blocked[0], blocked[1], needed[0], needed[1])) {
+				//Has to be looked at again whenever we try from here next
+				dirty[k] = 1;
+				return false;
+			}
+			dirty[k] = 0;
+
+			uint64_t rowReach = 0;
+			uint64_t colReach = 0;
+			for (int j = 0; j < domainSize[k]; j++) {
+				const placement &place = places[domain[domainStart[k] + j]];
+				rowReach |= place.rowMask;
+				colReach |= place.colMask;
+			}
+			reach[k * 2] = rowReach & board.rowBits[EMPTY][curRow];
+			reach[k * 2 + 1] = colReach & board.colBits[EMPTY][curCol];
+		}
+	}
+
+	for (int n = 0; n < numRows; n++) {
+		covered[n] = 0;
+		shared[n] = 0;
+	}
+	for (int k = 0; k < numNumbers; k++) {
+		int curRow = numbers[k].row;
+		int curCol = numbers[k].col;
+		uint64_t rowReach = reach[k * 2];
+		uint64_t colReach = reach[k * 2 + 1];
+		shared[curRow] |= covered[curRow] & rowReach;
+		covered[curRow] |= rowReach;
+		//Column reach, scatter it back into the rows
+		uint64_t bit = ((uint64_t)1) << curCol;
+		while (colReach != 0) {
+			int n = lowestBit(colReach);
+			colReach &= colReach - 1;
+			shared[n] |= covered[n] & bit;
+			covered[n] |= bit;
+		}
+	}
+	return true;
+}
+
+//Figures out which squares each number needs, the ones in every placement it has left, and if two numbers need the same one
+// reach: each number's reach from pruneDomains
+// needs gets the empty squares each number needs, in the same words as reach
+// needed gets (per row) every square some number needs
+// returns: false if two numbers need the same square, nothing can solve that
+bool Solver::needySquares(const uint64_t* reach, uint64_t* needs, uint64_t* needed) const {
+	for (int n = 0; n < numRows; n++) {
+		needed[n] = 0;
+	}
+	for (int k = 0; k < numNumbers; k++) {
+		int curRow = numbers[k].row;
+		int curCol = numbers[k].col;
+		uint64_t rowNeeds = reach[k * 2];
+		uint64_t colNeeds = reach[k * 2 + 1];
+		for (int i = 0; i < domainSize[k] && (rowNeeds | colNeeds) != 0; i++) {
+			const placement &place = places[domain[domainStart[k] + i]];
+			rowNeeds &= place.rowMask;
+			colNeeds &= place.colMask;
+		}
+		needs[k * 2] = rowNeeds;
+		needs[k * 2 + 1] = colNeeds;
+
+		if (needed[curRow] & rowNeeds) {
+			return false;
+		}
+		needed[curRow] |= rowNeeds;
+		uint64_t bit = ((uint64_t)1) << curCol;
+		while (colNeeds != 0) {
+			int n = lowestBit(colNeeds);
+			colNeeds &= colNeeds - 1;
+			if (needed[n] & bit) {
+				return false;
+			}
+			needed[n] |= bit;
+		}
+	}
+	return true;
+}
+
+//Searches under the board as it is, finding every solution below it
+// The search doesn't recurse, each node it is in the middle of sits on searchStack with the guesses it has left, and
+// the loop here always works on the top one. Trying a guess opens a new node on top, a node with nothing left gets closed.
+// Splitting into regions runs this again for each region, on top of the nodes already on the stack.
+void Solver::backtracker(vector<Cell**> &solutions) {
+	size_t base = searchStack.size();
+	openNode(solutions);
+	while (searchStack.size() > base) {
+		SearchFrame &frame = searchStack.back();
+		//Take back the last guess
+		undoTo(frame.guessMark);
+		undoDomainsTo(frame.guessDomainMark);
+		if (frame.next == frame.numGuesses || shouldStop()) {
+			closeNode();
+			continue;
+		}
+		int guess = frame.guesses[frame.next++];
+		if (pool != NULL && pool->hungry() && partials == NULL) {
+			//Other threads are short on work, hand this whole branch off with its own copy of everything
+			Solver* branch = splitOff();
+			branch->makeGuess(frame.arrowGuesses, guess);
+			handOff(branch);
+			continue;
+		}
+		makeGuess(frame.arrowGuesses, guess);
+		parentReach = frame.reach;
+		openNode(solutions);
+	}
+}
+
+//Opens a node for the board as it is, runs the rules over it and works out what to guess next
+// A node that turns out solved, dead or already searched is closed again straight away (or never opened).
+void Solver::openNode(vector<Cell**> &solutions) {
+	//Stepping through and stopping at guesses want to see every state
+	// Inside a region only that region's part gets searched, so what a board led to there doesn't hold for the whole board.
+	// Boards only go in the table once everything under them has been looked at, so skipping one never loses a solution.
+	bool tabled = table && mode != 2 && mode != 3 && partials == NULL;
+	if (tabled && table->contains(hash)) {
+		return;
+	}
+
+	//Found all the solutions we were asked for
+	if (shouldStop()) {
+		return;
+	}
+
+	if (mode == 3) {
+		cout << "Current State, " << searchDepth() << " guesses deep, about " << (int)(searchProgress() * 100) << "% searched" << endl;
+		Cell** current = toPuzzle(board);
+		printPuzzle(current);
+		deleteGrid(current, numRows);
+		system("pause");
+	}
+
+	//Where the trails were when we got here
+	SearchFrame frame;
+	frame.mark = trail.size();
+	frame.domainMark = domainTrail.size();
+	frame.scratchMark = scratch.mark();
+	frame.tabled = tabled;
+	frame.key = hash;
+	frame.handed = handOffs;
+	frame.guesses = NULL;
+	frame.numGuesses = 0;
+	frame.next = 0;
+	frame.arrowGuesses = branching == ARROW_BRANCHING;
+
+	//Start from the reach the node above finished with, only numbers it changed squares for need working out again
+	bool all = parentReach == NULL;
+	frame.reach = scratch.take<uint64_t>(numNumbers * 4);
+	if (!all) {
+		memcpy(frame.reach, parentReach, numNumbers * 2 * sizeof(uint64_t));
+	}
+	searchStack.push_back(frame);
+
+	if (propagate(solutions, frame.reach, all)) {
+		//Essentially max we could solve, return it as a solution to cheat and make this easy on myself
+		if (mode == 2) {
+			saveSolution(solutions);
+		}
+		//Parts of the board that can't touch each other any more get solved one at a time
+		else if (!splitRegions(solutions, frame.reach)) {
+			//We have to guess, increase difficulty
+			difficultyRate++;
+			if (branching == PLACEMENT_BRANCHING) {
+				guessPlacements(searchStack.back());
+			}
+			else {
+				guessArrows(searchStack.back());
+			}
+		}
+	}
+	searchStack.back().guessMark = trail.size();
+	searchStack.back().guessDomainMark = domainTrail.size();
+}
+
+//Closes the node on top of the stack, taking back everything it put down
+void Solver::closeNode() {
+	SearchFrame &frame = searchStack.back();
+	//Cut short by the solution limit or parts of it are still running on other threads
+	if (frame.tabled && handOffs == frame.handed && !shouldStop()) {
+		table->insert(frame.key);
+	}
+	undoTo(frame.mark);
+	undoDomainsTo(frame.domainMark);
+	scratch.release(frame.scratchMark);
+	searchStack.pop_back();
+}
+
+//Runs the rules over the board again and again until they stop forcing arrows
+// reach gets each number's reachable empty squares and needs the squares it has to take (see pruneDomains)
+// returns: false if there is nothing left to guess, the board is dead or it was a solution (and got saved)
+bool Solver::propagate(vector<Cell**> &solutions, uint64_t* reach, bool all) {
+	uint64_t* needs = reach + numNumbers * 2;
+	uint64_t covered[MAX_BOARD_SIZE];
+	uint64_t shared[MAX_BOARD_SIZE];
+	uint64_t needed[MAX_BOARD_SIZE];
+	while (true) {
+		//Do we have a solution? If so save it
+		if (partials == NULL ? isSolved(board) : regionSolved()) {
+			//Done stepping through (or guessing) once there is a solution
+			if (mode == 2 || mode == 3) {
+				mode = 1;
+			}
+			foundSolution(solutions);
+			return false;
+		}
+
+		//Throw out every placement the board has ruled out, no placements left means this state is dead.
+		// Check to see if a space can't be reached too.
+		bool alive = pruneDomains(reach, covered, shared, all);
+		all = false;
+		for (int n = 0; n < numRows && alive; n++) {
+			if (board.rowBits[EMPTY][n] & ~covered[n]) {
+				alive = false;
+			}
+		}
+
+		//Squares only one number can reach cut its domain down to placements that take them
+		for (int k = 0; k < numNumbers && alive; k++) {
+			int curRow = numbers[k].row;
+			int curCol = numbers[k].col;
+			uint64_t aloneRow = reach[k * 2] & covered[curRow] & ~shared[curRow];
+			uint64_t aloneCol = 0;
+			uint64_t rest = reach[k * 2 + 1];
+			while (rest != 0) {
+				int n = lowestBit(rest);
+				rest &= rest - 1;
+				if (((covered[n] & ~shared[n]) >> curCol) & 1) {
+					aloneCol |= ((uint64_t)1) << n;
+				}
+			}
+			if ((aloneRow | aloneCol) != 0) {
+				alive = pruneDomain(k, 0, 0, aloneRow, aloneCol);
+				//Its reach might have shrunk
+				dirty[k] = 1;
+			}
+		}
+
+		//Every number has to take the squares it needs, if two of them need the same one we are done here
+		alive = alive && needySquares(reach, needs, needed);
+		bool forced = false;
+		for (int k = 0; k < numNumbers && alive; k++) {
+			int curRow = numbers[k].row;
+			int curCol = numbers[k].col;
+			uint64_t needRow = needs[k * 2];
+			uint64_t needCol = needs[k * 2 + 1];
+			while (needRow != 0) {
+				int m = lowestBit(needRow);
+				needRow &= needRow - 1;
+				placeArrow(curRow, m, m > curCol ? RIGHT : LEFT);
+				forced = true;
+			}
+			while (needCol != 0) {
+				int n = lowestBit(needCol);
+				needCol &= needCol - 1;
+				placeArrow(n, curCol, n > curRow ? DOWN : UP);
+				forced = true;
+			}
+
+			//Someone used too many spaces :(
+			if (numbers[k].remaining < 0) {
+				alive = false;
+			}
+		}
+
+		if (!alive) {
+			return false;
+		}
+		if (!forced) {
+			return true;
+		}
+	}
+}
+
+//Sets a node up to guess one more arrow on the smallest unfinished number
+void Solver::guessArrows(SearchFrame &frame) {
+	//THIS IS THE END OF LEAST VALUES REMAINING NOW WE JUST TRY FROM LOWEST NUMBER GOING FOR LOWEST NUMBER OF BRANCHES
+	//Why do we not try based off which squares have the least amount of options you say?
+	//Because in practice (and solving them by hand) I found that the combination of these two methods was very effective
+	//And allows for agressive solving by the computer through our pruning option.
+	//Maybe I'm wrong, who knows.
+
+	//Find the smallest number that isn't done yet
+	currentNumber = 0;
+	while (currentNumber < numNumbers && (numbers[currentNumber].remaining == 0 || !activeNumber[currentNumber])) {
+		currentNumber++;
+	}
+	if (currentNumber == numNumbers) {
+		//Every number is done but there are still holes, the coverage check should have caught this
+		return;
+	}
+
+	//The new arrows we can, one step past the arrows the number already has in each direction
+	int row = numbers[currentNumber].row;
+	int col = numbers[currentNumber].col;
+	frame.guesses = scratch.take<int>(4);
+	frame.arrowGuesses = true;
+	for (int dir = 0; dir < 4; dir++) {
+		int nextRow, nextCol;
+		//Off the board, or its a number or a bad arrow and we can't
+		if (!board.step(row, col, dir, board.ownRun(row, col, dir) + 1, nextRow, nextCol) || board.get(nextRow, nextCol) != EMPTY) {
+			continue;
+		}
+		frame.guesses[frame.numGuesses++] = (nextRow * MAX_BOARD_SIZE + nextCol) * 4 + dir;
+	}
+}
+
+//Sets a node up to guess whole placements, for whichever number or empty square has the fewest placements left to pick from
+// Every guess covers the number (or square) a different way, so no solution turns up twice.
+void Solver::guessPlacements(SearchFrame &frame) {
+	//Number with the fewest placements left
+	int bestNumber = -1;
+	int fewest = 0;
+	for (int k = 0; k < numNumbers; k++) {
+		if (numbers[k].remaining > 0 && activeNumber[k] && (bestNumber == -1 || domainSize[k] < fewest)) {
+			bestNumber = k;
+			fewest = domainSize[k];
+		}
+	}
+	if (bestNumber == -1) {
+		//Every number is done but there are still holes, the coverage check should have caught this
+		return;
+	}
+
+	//Count how many placements could cover each empty square, one of them has to
+	int* options = scratch.take<int>(numRows * numCols);
+	for (int i = 0; i < numRows * numCols; i++) {
+		options[i] = 0;
+	}
+	for (int k = 0; k < numNumbers; k++) {
+		if (!activeNumber[k]) {
+			continue;
+		}
+		int curRow = numbers[k].row;
+		int curCol = numbers[k].col;
+		for (int i = 0; i < domainSize[k]; i++) {
+			const placement &place = places[domain[domainStart[k] + i]];
+			uint64_t rowTake = place.rowMask & board.rowBits[EMPTY][curRow];
+			uint64_t colTake = place.colMask & board.colBits[EMPTY][curCol];
+			while (rowTake != 0) {
+				options[curRow * numCols + lowestBit(rowTake)]++;
+				rowTake &= rowTake - 1;
+			}
+			while (colTake != 0) {
+				options[lowestBit(colTake) * numCols + curCol]++;
+				colTake &= colTake - 1;
+			}
+		}
+	}
+	int bestSquare = -1;
+	for (int i = 0; i < numRows * numCols; i++) {
+		if (options[i] > 0 && options[i] < fewest) {
+			bestSquare = i;
+			fewest = options[i];
+		}
+	}
+
+	//Gather the placements to try, there are fewest of them
+	frame.guesses = scratch.take<int>(fewest);
+	frame.arrowGuesses = false;
+	if (bestSquare == -1) {
+		for (int i = 0; i < domainSize[bestNumber]; i++) {
+			frame.guesses[frame.numGuesses++] = domain[domainStart[bestNumber] + i];
+		}
+	}
+	else {
+		int row = bestSquare / numCols;
+		int col = bestSquare % numCols;
+		for (int k = 0; k < numNumbers; k++) {
+			if ((numbers[k].row != row && numbers[k].col != col) || !activeNumber[k]) {
+				continue;
+			}
+			for (int i = 0; i < domainSize[k]; i++) {
+				const placement &place = places[domain[domainStart[k] + i]];
+				if ((numbers[k].row == row && ((place.rowMask >> col) & 1)) || (numbers[k].col == col && ((place.colMask >> row) & 1))) {
+					frame.guesses[frame.numGuesses++] = domain[domainStart[k] + i];
+				}
+			}
+		}
+	}
+}
+
+//Puts down a guess, one arrow (cell * 4 + dir, like the answers of a region) or a whole placement
+void Solver::makeGuess(bool arrow, int guess) {
+	if (arrow) {
+		int cell = guess / 4;
+		placeArrow(cell / MAX_BOARD_SIZE, cell % MAX_BOARD_SIZE, guess % 4);
+	}
+	else {
+		takePlacement(places[guess]);
+	}
+}
+
+//How many guesses deep the search is
+size_t Solver::searchDepth() const {
+	return searchStack.size();
+}
+
+//Rough share of the search done so far, counting every guess at a node as the same size
+double Solver::searchProgress() const {
+	double done = 0;
+	double share = 1;
+	for (size_t i = 0; i < searchStack.size(); i++) {
+		const SearchFrame &frame = searchStack[i];
+		if (frame.numGuesses == 0) {
+			break;
+		}
+		share /= frame.numGuesses;
+		//The guess being looked at right now is the one before next
+		done += share * (frame.next > 0 ? frame.next - 1 : 0);
+	}
+	return done;
+}
+
+//Splits the board into regions no unfinished number can reach across, solves each one on its own and puts the answers together
+// Two numbers are in the same region when they can reach the same empty square (or are joined up through others that can).
+// Each region's search only records the arrows it put down, then every pick of one answer per region makes a solution,
+// so unrelated corners of the board cost the sum of their searches instead of the product.
+// returns: false if there is only one region, then the caller just guesses like normal
+bool Solver::splitRegions(vector<Cell**> &solutions, const uint64_t* reach) {
+	//Union find over the numbers, joining them whenever they can reach the same square
+	ArenaMark frame = scratch.mark();
+	int* group = scratch.take<int>(numNumbers);
+	int* reachedBy = scratch.take<int>(numRows * numCols);
+	for (int k = 0; k < numNumbers; k++) {
+		group[k] = k;
+	}
+	for (int cell = 0; cell < numRows * numCols; cell++) {
+		reachedBy[cell] = -1;
+	}
+	for (int k = 0; k < numNumbers; k++) {
+		if (numbers[k].remaining == 0 || !activeNumber[k]) {
+			continue;
+		}
+		int curRow = numbers[k].row;
+		int curCol = numbers[k].col;
+		uint64_t rowReach = 0;
+		uint64_t colReach = 0;
+		for (int i = 0; i < domainSize[k]; i++) {
+			const placement &place = places[domain[domainStart[k] + i]];
+			rowReach |= place.rowMask;
+			colReach |= place.colMask;
+		}
+		rowReach &= board.rowBits[EMPTY][curRow];
+		colReach &= board.colBits[EMPTY][curCol];
+		while ((rowReach | colReach) != 0) {
+			int cell;
+			if (rowReach != 0) {
+				cell = curRow * numCols + lowestBit(rowReach);
+				rowReach &= rowReach - 1;
+			}
+			else {
+				cell = lowestBit(colReach) * numCols + curCol;
+				colReach &= colReach - 1;
+			}
+			if (reachedBy[cell] == -1) {
+				reachedBy[cell] = k;
+				continue;
+			}
+			int a = k;
+			int b = reachedBy[cell];
+			while (group[a] != a) {
+				a = group[a] = group[group[a]];
+			}
+			while (group[b] != b) {
+				b = group[b] = group[group[b]];
+			}
+			group[a] = b;
+		}
+	}
+
+	//Number the regions
+	int* regionOf = scratch.take<int>(numNumbers);
+	int numRegions = 0;
+	for (int k = 0; k < numNumbers; k++) {
+		regionOf[k] = -1;
+	}
+	for (int k = 0; k < numNumbers; k++) {
+		if (numbers[k].remaining == 0 || !activeNumber[k]) {
+			continue;
+		}
+		int root = k;
+		while (group[root] != root) {
+			root = group[root];
+		}
+		if (regionOf[root] == -1) {
+			regionOf[root] = numRegions++;
+		}
+		regionOf[k] = regionOf[root];
+	}
+	if (numRegions < 2) {
+		scratch.release(frame);
+		return false;
+	}
+	uint64_t* regionSquares = scratch.take<uint64_t>(numRegions * numRows);
+	for (int i = 0; i < numRegions * numRows; i++) {
+		regionSquares[i] = 0;
+	}
+	for (int cell = 0; cell < numRows * numCols; cell++) {
+		if (reachedBy[cell] != -1) {
+			regionSquares[regionOf[reachedBy[cell]] * numRows + cell / numCols] |= ((uint64_t)1) << (cell % numCols);
+		}
+	}
+
+	//Search each region by itself
+	char* oldActive = scratch.take<char>(numNumbers);
+	uint64_t* oldRegion = scratch.take<uint64_t>(numRows);
+	for (int k = 0; k < numNumbers; k++) {
+		oldActive[k] = activeNumber[k];
+	}
+	for (int n = 0; n < numRows; n++) {
+		oldRegion[n] = region[n];
+	}
+	RegionAnswers* oldPartials = partials;
+	size_t oldMark = regionMark;
+	vector<RegionAnswers> answers(numRegions);
+	bool possible = true;
+	for (int r = 0; r < numRegions && possible; r++) {
+		for (int k = 0; k < numNumbers; k++) {
+			activeNumber[k] = regionOf[k] == r;
+		}
+		for (int n = 0; n < numRows; n++) {
+			region[n] = regionSquares[r * numRows + n];
+		}
+		partials = &answers[r];
+		regionMark = trail.size();
+		parentReach = reach;
+		backtracker(solutions);
+		possible = answers[r].count != 0;
+	}
+	for (int k = 0; k < numNumbers; k++) {
+		activeNumber[k] = oldActive[k];
+	}
+	for (int n = 0; n < numRows; n++) {
+		region[n] = oldRegion[n];
+	}
+	partials = oldPartials;
+	regionMark = oldMark;
+	if (!possible || shouldStop()) {
+		scratch.release(frame);
+		return true;
+	}
+
+	//Put together every pick of one answer from each region
+	size_t mark = trail.size();
+	size_t* pick = scratch.take<size_t>(numRegions);
+	for (int r = 0; r < numRegions; r++) {
+		pick[r] = 0;
+	}
+	if (countOnly) {
+		//Each region fills in all of its own squares, so either every pick leaves the board full or none do
+		bool solves = true;
+		if (partials == NULL) {
+			uint64_t* filled = scratch.take<uint64_t>(numRows);
+			for (int n = 0; n < numRows; n++) {
+				filled[n] = board.rowBits[EMPTY][n];
+				for (int r = 0; r < numRegions; r++) {
+					filled[n] &= ~regionSquares[r * numRows + n];
+				}
+				solves = solves && filled[n] == 0;
+			}
+			//Same as the end of isSolved, loose arrows nobody owns
+			int total = 0;
+			for (int k = 0; k < numNumbers; k++) {
+				total += numbers[k].value;
+			}
+			solves = solves && total == numRows * numCols - numNumbers;
+		}
+		countRegions(answers, pick, solves);
+		scratch.release(frame);
+		return true;
+	}
+	while (true) {
+		for (int r = 0; r < numRegions; r++) {
+			const vector<int> &arrowsPut = answers[r].arrows[pick[r]];
+			for (int i = 0; i < arrowsPut.size(); i++) {
+				int cell = arrowsPut[i] / 4;
+				placeArrow(cell / MAX_BOARD_SIZE, cell % MAX_BOARD_SIZE, arrowsPut[i] % 4);
+			}
+		}
+		//Loose arrows nobody ended up owning would still stop it being a solution
+		if (partials != NULL || isSolved(board)) {
+			foundSolution(solutions);
+		}
+		undoTo(mark);
+		if (shouldStop()) {
+			break;
+		}
+		int r = 0;
+		while (r < numRegions && ++pick[r] == answers[r].count) {
+			pick[r] = 0;
+			r++;
+		}
+		if (r == numRegions) {
+			break;
+		}
+	}
+	scratch.release(frame);
+	return true;
+}
+
+//Counts every pick of one answer from each region without putting any of them on the board
+// Without a hash of the solutions it's just how many answers each region has multiplied together, otherwise
+// each pick's hash is the board's hash now with what every region changed from it mixed in.
+// solves is false if the picks would leave the whole board unfinished, then they don't count as solutions.
+void Solver::countRegions(const vector<RegionAnswers> &answers, size_t* pick, bool solves) {
+	int numRegions = (int)answers.size();
+	if (!hashSolutions) {
+		uint64_t picks = 1;
+		for (int r = 0; r < numRegions; r++) {
+			//Hang on to the most a 64 bit count can hold rather than wrapping around
+			picks = picks > UINT64_MAX / answers[r].count ? UINT64_MAX : picks * answers[r].count;
+		}
+		if (partials != NULL) {
+			partials->count = partials->count > UINT64_MAX - picks ? UINT64_MAX : partials->count + picks;
+		}
+		else if (solves) {
+			solutionCount = solutionCount > UINT64_MAX - picks ? UINT64_MAX : solutionCount + picks;
+			if (solutionLimit != 0 && solutionCount >= solutionLimit) {
+				solutionCount = solutionLimit;
+				stopped = true;
+			}
+		}
+		return;
+	}
+	while (solves) {
+		uint64_t key = hash;
+		for (int r = 0; r < numRegions; r++) {
+			key ^= answers[r].hashes[pick[r]] ^ hash;
+		}
+		if (partials != NULL) {
+			partials->count++;
+			partials->hashes.push_back(key);
+		}
+		else {
+			countSolution(key);
+		}
+		if (shouldStop()) {
+			break;
+		}
+		int r = 0;
+		while (r < numRegions && ++pick[r] == answers[r].count) {
+			pick[r] = 0;
+			r++;
+		}
+		if (r == numRegions) {
+			break;
+		}
+	}
+}
+
+//Is the region being searched on its own done, all its numbers finished and all its squares filled
+bool Solver::regionSolved() const {
+	for (int k = 0; k < numNumbers; k++) {
+		if (activeNumber[k] && numbers[k].remaining != 0) {
+			return false;
+		}
+	}
+	for (int n = 0; n < numRows; n++) {
+		if (board.rowBits[EMPTY][n] & region[n]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//A solution turned up, inside a region that means writing down the arrows the region put down, otherwise it gets saved
+void Solver::foundSolution(vector<Cell**> &solutions) {
+	if (partials == NULL) {
+		saveSolution(solutions);
+		return;
+	}
+	partials->count++;
+	if (countOnly) {
+		//Counting only needs the hash of the board with the answer on it, if that
+		if (hashSolutions) {
+			partials->hashes.push_back(hash);
+		}
+		return;
+	}
+	vector<int> arrowsPut;
+	for (size_t i = regionMark; i < trail.size(); i++) {
+		int cell = trail[i];
+		arrowsPut.push_back(cell * 4 + board.get(cell / MAX_BOARD_SIZE, cell % MAX_BOARD_SIZE));
+	}
+	partials->arrows.push_back(arrowsPut);
+}
+
+//Puts down the arrows of a placement the board doesn't have yet
+void Solver::takePlacement(const placement &place) {
+	int row = numbers[place.number].row;
+	int col = numbers[place.number].col;
+	uint64_t rowTake = place.rowMask & board.rowBits[EMPTY][row];
+	uint64_t colTake = place.colMask & board.colBits[EMPTY][col];
+	while (rowTake != 0) {
+		int m = lowestBit(rowTake);
+		rowTake &= rowTake - 1;
+		placeArrow(row, m, m > col ? RIGHT : LEFT);
+	}
+	while (colTake != 0) {
+		int n = lowestBit(colTake);
+		colTake &= colTake - 1;
+		placeArrow(n, col, n > row ? DOWN : UP);
+	}
+}
+
+//Copies everything into a new solver for another thread to carry on from this state
+Solver* Solver::splitOff() const {
+	Solver* branch = new Solver(*this);
+	branch->trail.clear();
+	branch->domainTrail.clear();
+	branch->difficultyRate = 0;
+	branch->parentReach = NULL;
+	branch->searchStack.clear();
+	return branch;
+}
+
+//Gives a split off branch to the pool, it cleans up after itself
+void Solver::handOff(Solver* branch) {
+	handOffs++;
+	pool->submit([branch]() {
+		branch->runBranch();
+		delete branch;
+	});
+}
+
+//True once we have as many solutions as we were asked for, on any thread
+// A region never needs more answers than the limit either, the picks from the other regions can only add to them.
+bool Solver::shouldStop() const {
+	if (partials != NULL && solutionLimit != 0 && partials->count >= solutionLimit) {
+		return true;
+	}
+	return stopped || (collector != NULL && collector->stop.load());
+}
+
+//Saves the solution on the board, unless we already have it
+// Solutions are told apart by the board's hash, so checking for a repeat never has to build or compare whole boards.
+// Reaching the solution limit stops the search.
+void Solver::saveSolution(vector<Cell**> &solutions) {
+	if (countOnly) {
+		countSolution(hash);
+		return;
+	}
+	if (sink != NULL) {
+		//Streaming guesses placements too, so no repeats to look out for
+		fillPuzzle(board, sinkGrid);
+		(*sink)(sinkGrid);
+		countSolution(hash);
+		return;
+	}
+	if (collector != NULL) {
+		collector->add(*this, hash);
+		return;
+	}
+	if (!seenSolutions.insert(hash).second) {
+		//Same solution by a different order of arrows
+		return;
+	}
+	solutions.push_back(toPuzzle(board));
+	if (solutionLimit != 0 && seenSolutions.size() >= solutionLimit) {
+		stopped = true;
+	}
+}
+
+//Mixes up a board's hash before it gets added into the hash of all the solutions
+// Boards' hashes are arrows xor'd together, so adding them up as they are could let different sets of solutions cancel out the same way.
+static uint64_t mixSolutionHash(uint64_t key) {
+	key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+	return key ^ (key >> 31);
+}
+
+//Counts the solution with hash key instead of saving it
+// A count only (or streaming) solve always guesses whole placements, and no two of those can ever lead to the same solution,
+// so unlike saveSolution there's no need to remember what was found to throw out repeats.
+void Solver::countSolution(uint64_t key) {
+	if (solutionCount != UINT64_MAX) {
+		solutionCount++;
+	}
+	if (hashSolutions) {
+		//Adding them up means the order they are found in doesn't matter
+		solutionHash += mixSolutionHash(key);
+	}
+	if (solutionLimit != 0 && solutionCount >= solutionLimit) {
+		stopped = true;
+	}
+}
+
+//Runs the backtracker on a state with a solution limit just for this solve
+void Solver::solveUpTo(vector<Cell**> &solutions, const Bitboard &puzzleState, size_t limit) {
+	size_t oldLimit = solutionLimit;
+	solutionLimit = limit;
+	backtracker(solutions, puzzleState);
+	solutionLimit = oldLimit;
+}
+
+//Deletes every board in a solutions vector and empties it
+void Solver::freeSolutions(vector<Cell**> &solutions) const {
+	for (int i = 0; i < solutions.size(); i++) {
+		deleteGrid(solutions[i], numRows);
+	}
+	solutions.clear();
+}
+
+//Checks if a puzzle grid has exactly one solution
+// This is the inner loop of creation, so the search stops the moment a second different solution turns up.
+bool Solver::isUnique(Cell** puzzleState) {
+	size_t oldLimit = solutionLimit;
+	solutionLimit = 2;
+	bool unique = countSolutions(puzzleState) == 1;
+	solutionLimit = oldLimit;
+	return unique;
+}
+
+//Counts the solutions of a puzzle grid without keeping any of them
+// Solutions are counted as they turn up and never built into grids or remembered, so memory stays the same however
+// many there are. Regions split off by splitRegions just get their answer counts multiplied (unless hashing).
+uint64_t Solver::countSolutions(Cell** puzzleState, uint64_t* solutionsHash) {
+	int oldMode = mode;
+	int oldBranching = branching;
+	mode = 1;
+	branching = PLACEMENT_BRANCHING;
+	countOnly = true;
+	hashSolutions = solutionsHash != NULL;
+	solutionCount = 0;
+	solutionHash = 0;
+
+	vector<Cell**> none;
+	backtracker(none, loadBitboard(puzzleState));
+
+	mode = oldMode;
+	branching = oldBranching;
+	countOnly = false;
+	if (solutionsHash != NULL) {
+		*solutionsHash = solutionHash;
+	}
+	return solutionCount;
+}
+
+//Hands every solution of a puzzle grid to sink as it's found
+// Nothing is kept between solutions, they all get written into the same grid, so memory doesn't grow with how many
+// there are and whoever is on the other end of the sink can get to work on the first one straight away.
+uint64_t Solver::streamSolutions(Cell** puzzleState, const SolutionSink &solutionSink) {
+	int oldMode = mode;
+	int oldBranching = branching;
+	mode = 1;
+	branching = PLACEMENT_BRANCHING;
+	hashSolutions = false;
+	solutionCount = 0;
+	sink = &solutionSink;
+	sinkGrid = newGrid(numRows, numCols);
+
+	vector<Cell**> none;
+	backtracker(none, loadBitboard(puzzleState));
+
+	deleteGrid(sinkGrid, numRows);
+	sinkGrid = NULL;
+	sink = NULL;
+	mode = oldMode;
+	branching = oldBranching;
+	return solutionCount;
+}
+
+//Starts the backtracker on a puzzle state
+void Solver::backtracker(vector<Cell**> &solutions, const Bitboard &puzzleState) {
+	board = puzzleState;
+	trail.clear();
+	stopped = false;
+	seenSolutions.clear();
+	updateRemaining(board);
+	buildDomains();
+	activeNumber.assign(numNumbers, 1);
+	parentReach = NULL;
+
+	//Hash up the arrows already on the board, and start the table fresh
+	hash = hashArrows(board);
+	if (tableBytes == 0) {
+		table.reset();
+	}
+	else if (!table || table->bytes() > tableBytes || table->bytes() * 2 <= tableBytes) {
+		table.reset(new TranspositionTable(tableBytes));
+	}
+	else {
+		table->newSearch();
+	}
+	backtracker(solutions);
+}
+
+//Starts the backtracker on a character grid
+void Solver::backtracker(vector<Cell**> &solutions, Cell** puzzleState) {
+	backtracker(solutions, loadBitboard(puzzleState));
+}
+
+//Hands over a solution a thread found, it only gets turned into a grid if nobody has found it yet
+void SolutionCollector::add(const Solver &found, uint64_t key) {
+	lock_guard<mutex> guard(lock);
+	//Someone else got there first
+	if (stop || !seen.insert(key).second) {
+		return;
+	}
+	solutions.push_back(found.currentPuzzle());
+	if (limit != 0 && solutions.size() >= limit) {
+		stop = true;
+	}
+}
+
+//Adds on the guesses a thread made
+void SolutionCollector::addGuesses(double guessed) {
+	lock_guard<mutex> guard(lock);
+	guesses += guessed;
+}
+
+//Runs a branch handed to the pool, its solutions go straight to the collector
+void Solver::runBranch() {
+	vector<Cell**> found;
+	backtracker(found);
+	collector->addGuesses(difficultyRate);
+}
+
+//Solves from a puzzle grid using a pool of threads
+// This thread starts the search, and whenever the pool is short on work a guess branch gets split off as its own task.
+// Every branch has its own copy of the solver so nothing is shared but the pool and the collector.
+void Solver::parallelBacktracker(vector<Cell**> &solutions, Cell** puzzleState, int threads) {
+	WorkStealingPool workers(threads);
+	SolutionCollector found(solutionLimit);
+	mode = 1;
+	pool = &workers;
+	collector = &found;
+
+	backtracker(solutions, loadBitboard(puzzleState));
+	workers.wait();
+
+	pool = NULL;
+	collector = NULL;
+	solutions.insert(solutions.end(), found.solutions.begin(), found.solutions.end());
+	difficultyRate += found.guesses;
+}
+
+//Every placement a number could use on a state, arms can run over empty squares and its own loose arrows but nothing else
+void Solver::placementsFor(const Bitboard &state, int k, vector<placement> &found) const {
+	const number &num = numbers[k];
+	uint64_t open[4];
+	numberRays(state, &k, 1, false, open);
+	int longest[4];
+	for (int dir = 0; dir < 4; dir++) {
+		longest[dir] = min(popCount(open[dir]), num.value);
+	}
+
+	//Pick up, right and down, whatever is left has to go left
+	placement place;
+	place.number = k;
+	for (int up = 0; up <= longest[UP]; up++) {
+		for (int right = 0; right <= longest[RIGHT] && up + right <= num.value; right++) {
+			for (int down = 0; down <= longest[DOWN] && up + right + down <= num.value; down++) {
+				int left = num.value - up - right - down;
+				if (left > longest[LEFT]) {
+					continue;
+				}
+				place.length[UP] = up;
+				place.length[RIGHT] = right;
+				place.length[DOWN] = down;
+				place.length[LEFT] = left;
+				place.rowMask = (((((uint64_t)1) << right) - 1) << (num.col + 1)) | (((((uint64_t)1) << left) - 1) << (num.col - left));
+				place.colMask = (((((uint64_t)1) << down) - 1) << (num.row + 1)) | (((((uint64_t)1) << up) - 1) << (num.row - up));
+				found.push_back(place);
+			}
+		}
+	}
+}
+
+//Sets up every number's domain with all the placements it could use on the board
+void Solver::buildDomains() {
+	places.clear();
+	domain.clear();
+	domainStart.assign(numNumbers, 0);
+	domainSize.assign(numNumbers, 0);
+	domainTrail.clear();
+	dirty.assign(numNumbers, 1);
+	for (int k = 0; k < numNumbers; k++) {
+		domainStart[k] = (int)places.size();
+		placementsFor(board, k, places);
+		domainSize[k] = (int)places.size() - domainStart[k];
+	}
+	for (int i = 0; i < places.size(); i++) {
+		domain.push_back(i);
+	}
+}
+
+//Throws out the placements of number k that touch a blocked square or miss a needed one (all in its row and column words)
+// returns: false if there is nothing left
+bool Solver::pruneDomain(int k, uint64_t rowBlocked, uint64_t colBlocked, uint64_t rowNeeded, uint64_t colNeeded) {
+	//data() and not [], a number with no placements starts right at the end (and the domain can be empty)
+	int* items = domain.data() + domainStart[k];
+	int size = domainSize[k];
+	for (int i = 0; i < size; ) {
+		const placement &place = places[items[i]];
+		if ((place.rowMask & rowBlocked) != 0 || (place.colMask & colBlocked) != 0 || (rowNeeded & ~place.rowMask) != 0 || (colNeeded & ~place.colMask) != 0) {
+			//Dead, swap it out past the end
+			size--;
+			swap(items[i], items[size]);
+		}
+		else {
+			i++;
+		}
+	}
+	if (size != domainSize[k]) {
+		domainTrail.push_back(make_pair(k, domainSize[k]));
+		domainSize[k] = size;
+	}
+	return size != 0;
+}
+
+//Draws the arrows of a placement onto a state
+void Solver::applyPlacement(Bitboard &state, const placement &place) const {
+	const number &num = numbers[place.number];
+	for (int dir = 0; dir < 4; dir++) {
+		for (int i = 1; i <= place.length[dir]; i++) {
+			int row, col;
+			state.step(num.row, num.col, dir, i, row, col);
+			state.set(row, col, dir);
+		}
+	}
+}
+
+//Solves from a puzzle grid as an exact cover problem
+// There is a column for every number (it has to pick exactly one placement) and one for every other square (it
+// has to be covered by exactly one arm), and a row for every placement of every number. Any exact cover is a solution.
+void Solver::dancingLinks(vector<Cell**> &solutions, Cell** puzzleState) {
+	board = loadBitboard(puzzleState);
+	updateRemaining(board);
+	stopped = false;
+	seenSolutions.clear();
+
+	//Columns for the squares come after the numbers
+	vector<int> squareColumn(numRows * numCols, -1);
+	int numColumns = numNumbers;
+	for (int n = 0; n < numRows; n++) {
+		for (int m = 0; m < numCols; m++) {
+			if (board.get(n, m) != NUMBER) {
+				squareColumn[n * numCols + m] = numColumns++;
+			}
+		}
+	}
+
+	DancingLinks matrix(numColumns);
+	vector<placement> places;
+	for (int k = 0; k < numNumbers; k++) {
+		placementsFor(board, k, places);
+	}
+	vector<int> columns;
+	for (int i = 0; i < places.size(); i++) {
+		const number &num = numbers[places[i].number];
+		columns.clear();
+		columns.push_back(places[i].number);
+		for (int dir = 0; dir < 4; dir++) {
+			for (int j = 1; j <= places[i].length[dir]; j++) {
+				int row, col;
+				board.step(num.row, num.col, dir, j, row, col);
+				columns.push_back(squareColumn[row * numCols + col]);
+			}
+		}
+		matrix.addRow(columns);
+	}
+
+	//Draw each cover onto a copy of the starting board
+	Bitboard start = board;
+	matrix.solve([&](const vector<int> &chosen) {
+		board = start;
+		for (int i = 0; i < chosen.size(); i++) {
+			applyPlacement(board, places[chosen[i]]);
+		}
+		hash = hashArrows(board);
+		saveSolution(solutions);
+		return !stopped;
+	});
+	board = start;
+	difficultyRate += matrix.guesses;
+}
+
+// Will create a puzzle using random methods along with pruning. The difficulty will tune the guesses needed to solve the puzzle.
+// Your puzzle.txt should follow the format of normal file inputs and can be anywhere from all X to completed (but why). In the end it will be overwritten with the completed puzzle.
+// Each step checks the puzzle so far and, if it isn't unique yet, drops a new number on a square nobody reaches. The steps
+// in progress sit on creationStack instead of recursing, so boards that need lots of numbers can't run out of stack.
+// It gives up after maxCreationSolves candidate puzzles, solutions is then left empty.
+void Solver::puzzleCreation(Cell** puzzleState, vector<Cell**> &solutions) {
+
+	//Every random choice comes from the seed, so the same seed always makes the same puzzle
+	Random random(seed);
+
+	//Deep copy our current state, new numbers get written into it and taken back off as we go
+	ArenaMark start = scratch.mark();
+	Cell** puzzle = scratch.take<Cell*>(numRows);
+	Cell* cells = scratch.take<Cell>(numRows * numCols);
+
+	//Create and intialize puzzle
+	for (int n = 0; n < numRows; n++) {
+		puzzle[n] = cells + n * numCols;
+		for (int m = 0; m < numCols; m++) {
+			puzzle[n][m] = puzzleState[n][m];
+		}
+	}
+
+	//The board creation works on, numbers get set on it and taken back off along with the puzzle
+	Bitboard state = loadBitboard(puzzle);
+
+	creationStack.clear();
+	creationSolves = 0;
+	openCreation(puzzle, solutions);
+	while (!creationStack.empty() && solutions.size() != 1 && creationSolves < maxCreationSolves) {
+		CreationFrame &frame = creationStack.back();
+		int curRow = frame.cell / numCols;
+		int curCol = frame.cell % numCols;
+
+		//The step above didn't work out, take its number back off
+		if (frame.placed) {
+			frame.placed = false;
+			numNumbers--;
+			for (int i = 0; i < numbers.size(); i++) {
+				if (numbers[i].row == curRow && numbers[i].col == curCol) {
+					numbers.erase(numbers.begin() + i);
+				}
+			}
+		}
+
+		if (frame.numSizes == 0) {
+			//No size worked here, put the square back
+			if (frame.cell != -1) {
+				puzzle[curRow][curCol] = BLANK;
+				state.set(curRow, curCol, EMPTY);
+				frame.cell = -1;
+			}
+			//Out of squares, this path is bad
+			if (frame.numCells == 0) {
+				scratch.release(frame.scratchMark);
+				creationStack.pop_back();
+				continue;
+			}
+			//Pick another square at random
+			int idx = random.below(frame.numCells);
+			frame.cell = frame.cells[idx];
+			frame.numSizes = frame.largest[idx];
+			for (int i = 0; i < frame.numSizes; i++) {
+				frame.sizes[i] = i + 1;
+			}
+			frame.numCells--;
+			frame.cells[idx] = frame.cells[frame.numCells];
+			frame.largest[idx] = frame.largest[frame.numCells];
+			continue;
+		}
+
+		//Randomly pick sizes until we are out of them and we know this square is bad.
+		int idx = random.below(frame.numSizes);
+		int size = frame.sizes[idx];
+		frame.numSizes--;
+		frame.sizes[idx] = frame.sizes[frame.numSizes];
+		puzzle[curRow][curCol] = (Cell)size;
+		state.set(curRow, curCol, NUMBER);
+		number num;
+		num.value = size;
+		num.remaining = size;
+		num.col = curCol;
+		num.row = curRow;
+		numbers.push_back(num);
+		numNumbers++;
+		frame.placed = true;
+		growCreation(state, solutions, curRow, curCol, size);
+	}
+	if (solutions.size() == 1) {
+		mode = 1;
+	}
+
+	//Clean up
+	creationStack.clear();
+	scratch.release(start);
+}
+
+//Starts puzzle creation on the puzzle as it is, the first step only goes on the stack if there are new numbers to try
+// If the puzzle is already unique its solution is left in solutions.
+void Solver::openCreation(Cell** puzzle, vector<Cell**> &solutions) {
+	ArenaMark frame = scratch.mark();
+	Bitboard state = loadBitboard(puzzle);
+
+	//Update remaining values of puzzle.
+	updateRemaining(state);
+	//Not valid, don't continue
+	if (!isValid(state)) {
+		return;
+	}
+	//Check if we have solveable puzzle, all that matters is if there is exactly one so stop looking at a second
+	if (creationSolved(state, solutions)) {
+		return;
+	}
+
+	//Work out which squares the numbers we have can still reach and which ones they need. Anything nobody reaches
+	// is where a new number can go, and a new number can't run through a square someone else needs.
+	board = state;
+	buildDomains();
+	uint64_t* covered = scratch.take<uint64_t>(numRows);
+	uint64_t* needed = scratch.take<uint64_t>(numRows);
+	uint64_t shared[MAX_BOARD_SIZE];
+	uint64_t* reach = scratch.take<uint64_t>(numNumbers * 4);
+	uint64_t* needs = reach + numNumbers * 2;
+	bool possible = pruneDomains(reach, covered, shared, true) && needySquares(reach, needs, needed);
+	if (!possible) {
+		//A number can't fit or two numbers need the same square, no new number will fix that
+		scratch.release(frame);
+		return;
+	}
+
+	//Check number of open squares and the number of needed squares.
+	int needSquares = 0;
+	for (int n = 0; n < numNumbers; n++) {
+		needSquares += numbers[n].remaining;
+	}
+	pushCreation(state, frame, covered, needed, needSquares, state.count(EMPTY));
+}
+
+//Solves a puzzle creation came up with, it's only kept if it's unique and its rating is in the band we were asked for
+// The guesses that solve took become difficultyRate, so the rating printed at the end is the puzzle's own and not
+// everything creation tried on the way there.
+// returns: true if it's a keeper, its solution is then left in solutions
+bool Solver::creationSolved(const Bitboard &state, vector<Cell**> &solutions) {
+	creationSolves++;
+	double before = difficultyRate;
+	solveUpTo(solutions, state, 2);
+	double guesses = difficultyRate - before;
+	if (solutions.size() == 1) {
+		double rated = rating(guesses, 1);
+		if (rated >= lowestRating && rated <= highestRating) {
+			difficultyRate = guesses;
+			return true;
+		}
+	}
+	freeSolutions(solutions);
+	return false;
+}
+
+//Carries on creation after a new number of value went down on (row, col), a square none of the numbers before reached
+// Nothing the step before worked out about the other numbers changes (see CreationFrame), so instead of building
+// every number's domain again only the new number gets looked at. The board only gets solved once the numbers
+// reach every empty square, before that it can't have a solution.
+void Solver::growCreation(const Bitboard &state, vector<Cell**> &solutions, int row, int col, int value) {
+	const CreationFrame &parent = creationStack.back();
+	ArenaMark frame = scratch.mark();
+	uint64_t newReach[2];
+	uint64_t newNeeds[2];
+	int remaining;
+	if (!newNumberReach(state, row, col, value, newReach, newNeeds, remaining)) {
+		return;
+	}
+
+	//Add the new number on, its row word goes straight in and its column word gets scattered back into the rows
+	uint64_t* covered = scratch.take<uint64_t>(numRows);
+	uint64_t* needed = scratch.take<uint64_t>(numRows);
+	bool reachesAll = true;
+	for (int n = 0; n < numRows; n++) {
+		uint64_t rowReach = n == row ? newReach[0] : 0;
+		uint64_t rowNeeds = n == row ? newNeeds[0] : 0;
+		if ((newReach[1] >> n) & 1) {
+			rowReach |= ((uint64_t)1) << col;
+		}
+		if ((newNeeds[1] >> n) & 1) {
+			rowNeeds |= ((uint64_t)1) << col;
+		}
+		//Someone else already needs a square it needs
+		if (parent.needed[n] & rowNeeds) {
+			scratch.release(frame);
+			return;
+		}
+		covered[n] = parent.covered[n] | rowReach;
+		needed[n] = parent.needed[n] | rowNeeds;
+		reachesAll = reachesAll && (state.rowBits[EMPTY][n] & ~covered[n]) == 0;
+	}
+	int needSquares = parent.needSquares + remaining;
+	int openSquares = parent.openSquares - 1;
+	if (needSquares > openSquares) {
+		scratch.release(frame);
+		return;
+	}
+
+	if (reachesAll) {
+		//Check if we have solveable puzzle, all that matters is if there is exactly one so stop looking at a second
+		creationSolved(state, solutions);
+		//Nowhere left for a new number either way
+		scratch.release(frame);
+		return;
+	}
+	pushCreation(state, frame, covered, needed, needSquares, openSquares);
+}
+
+//What a number of value on (row, col) could reach and would have to take, the same as pruneDomains and needySquares
+// would work out from all its placements, but straight from its rays.
+// Along each ray a placement has to reach at least as far as the number's own arrows out there go and can't run past
+// the open squares, and the lengths have to add up to value. So the furthest it can go one way is whatever the
+// others leave at their shortest, and the least it has to go is whatever the others can't take at their longest.
+// reach and needs get its row word then its column word, remaining how many arrows it still needs
+// returns: false if it has no placements at all
+bool Solver::newNumberReach(const Bitboard &state, int row, int col, int value, uint64_t* reach, uint64_t* needs, int &remaining) const {
+	uint64_t open[4];
+	int shortest[4];
+	int longest[4];
+	int totalShortest = 0;
+	int totalLongest = 0;
+	remaining = value;
+	for (int dir = 0; dir < 4; dir++) {
+		open[dir] = state.openRay(row, col, dir);
+		longest[dir] = min(popCount(open[dir]), value);
+		//Out as far as the last of its own arrows along the ray
+		uint64_t own = open[dir] & state.line(dir, row, col, dir);
+		shortest[dir] = 0;
+		if (own != 0) {
+			int last = towardsHigh(dir) ? highestBit(own) : lowestBit(own);
+			shortest[dir] = abs(last - Bitboard::linePos(row, col, dir));
+		}
+		totalShortest += shortest[dir];
+		totalLongest += longest[dir];
+		remaining -= state.ownRun(row, col, dir);
+	}
+	if (totalShortest > value || totalLongest < value) {
+		return false;
+	}
+	reach[0] = reach[1] = 0;
+	needs[0] = needs[1] = 0;
+	for (int dir = 0; dir < 4; dir++) {
+		int most = min(longest[dir], value - (totalShortest - shortest[dir]));
+		int least = max(shortest[dir], value - (totalLongest - longest[dir]));
+		int word = horizontal(dir) ? 0 : 1;
+		reach[word] |= firstAlongRay(open[dir], most, dir) & state.line(EMPTY, row, col, dir);
+		needs[word] |= firstAlongRay(open[dir], least, dir) & state.line(EMPTY, row, col, dir);
+	}
+	return true;
+}
+
+//Puts a step of creation on the stack with every square nobody reaches as somewhere to try a new number, if there are any
+// frame is where the scratch arena was when the step started, covered and needed have to have been taken after it
+void Solver::pushCreation(const Bitboard &state, ArenaMark frame, uint64_t* covered, uint64_t* needed, int needSquares, int openSquares) {
+	//Not valid
+	if (needSquares > openSquares) {
+		scratch.release(frame);
+		return;
+	}
+	//Needed squares by column too, for new numbers looking up and down
+	uint64_t neededCols[MAX_BOARD_SIZE];
+	for (int m = 0; m < numCols; m++) {
+		neededCols[m] = 0;
+	}
+	for (int n = 0; n < numRows; n++) {
+		uint64_t cells = needed[n];
+		while (cells != 0) {
+			neededCols[lowestBit(cells)] |= ((uint64_t)1) << n;
+			cells &= cells - 1;
+		}
+	}
+
+	//Check to see if a space can't be reached, those squares are where the next number can go
+	CreationFrame step;
+	step.scratchMark = frame;
+	step.cells = scratch.take<int>(numRows * numCols);
+	step.largest = scratch.take<int>(numRows * numCols);
+	step.numCells = 0;
+	step.cell = -1;
+	step.numSizes = 0;
+	step.placed = false;
+	step.covered = covered;
+	step.needed = needed;
+	step.needSquares = needSquares;
+	step.openSquares = openSquares;
+	for (int curRow = 0; curRow < numRows; curRow++) {
+		uint64_t unreached = state.rowBits[EMPTY][curRow] & ~covered[curRow];
+		while (unreached != 0) {
+			int curCol = lowestBit(unreached);
+			unreached &= unreached - 1;
+
+			//Find sizes that can fit there, running over empty squares nobody needs
+			uint64_t open[4], start[4], runs[4];
+			for (int dir = 0; dir < 4; dir++) {
+				open[dir] = state.line(EMPTY, curRow, curCol, dir) & ~(horizontal(dir) ? needed[curRow] : neededCols[curCol]);
+				start[dir] = upToAlongRay(Bitboard::linePos(curRow, curCol, dir), dir);
+			}
+			rayRuns(open, start, runs, 1);
+			int max = 0;
+			for (int dir = 0; dir < 4; dir++) {
+				max += popCount(runs[dir]);
+			}
+			//Max is wrong
+			if (max > openSquares) {
+				max = openSquares;
+			}
+			//Biggest clue a grid can hold
+			if (max > MAX_CLUE) {
+				max = MAX_CLUE;
+			}
+			if (max != 0) {
+				step.cells[step.numCells] = curRow * numCols + curCol;
+				step.largest[step.numCells] = max;
+				step.numCells++;
+			}
+		}
+	}
+	if (step.numCells == 0) {
+		scratch.release(frame);
+		return;
+	}
+	//Room for the sizes of whichever square ends up being tried
+	int most = 0;
+	for (int i = 0; i < step.numCells; i++) {
+		most = max(most, step.largest[i]);
+	}
+	step.sizes = scratch.take<int>(most);
+	creationStack.push_back(step);
+}
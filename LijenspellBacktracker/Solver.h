@@ -0,0 +1,340 @@
+//
+// Solver.h : Everything one Lijenspel solve (or creation) needs
+//
+//  All the state the backtracker and puzzle creation work on lives in a Solver instead of globals,
+//  so any number of puzzles can be solved side by side in one process, each on its own thread.
+//  A single Solver is not safe to share between threads.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include "Bitboard.h"
+#include "Grid.h"
+#include "WorkStealingPool.h"
+#include "DancingLinks.h"
+#include "TranspositionTable.h"
+#include "RayKernels.h"
+#include "ScratchArena.h"
+#include "Random.h"
+
+//Used to keep track of number locations in puzzle to speed up backtracking
+struct number {
+	int value, row, col, remaining;
+};
+
+//One way a number could lay out its arrows, how many go in each direction
+// The squares it covers are kept as masks too, rowMask in the number's row word and colMask in its column word.
+struct placement {
+	int number;
+	int length[4];
+	uint64_t rowMask, colMask;
+};
+
+//How the backtracker guesses when nothing is forced
+// ARROW_BRANCHING tries one more arrow at a time on the smallest unfinished number,
+// PLACEMENT_BRANCHING tries every whole placement of the number or square with the fewest left.
+enum Branching { ARROW_BRANCHING, PLACEMENT_BRANCHING };
+
+//A node the backtracker is in the middle of, see Solver::backtracker
+struct SearchFrame {
+	//Where the trails and the scratch arena were when the node was opened, closing it puts them all back
+	size_t mark, domainMark;
+	ArenaMark scratchMark;
+
+	//Where the trails were once the rules stopped forcing arrows, each guess starts back from here
+	size_t guessMark, guessDomainMark;
+
+	//Whether the board goes in the table (under key) once it's finished, and how many hand offs there were when it was opened
+	bool tabled;
+	uint64_t key;
+	int handed;
+
+	//Each number's reach and needs when the rules stopped (see pruneDomains)
+	uint64_t* reach;
+
+	//What to guess, placement indexes or single arrows (cell * 4 + dir), and which one is next
+	int* guesses;
+	int numGuesses;
+	int next;
+	bool arrowGuesses;
+};
+
+//A step of puzzle creation, see Solver::puzzleCreation
+struct CreationFrame {
+	//Where the scratch arena was when the step started
+	ArenaMark scratchMark;
+
+	//Squares nobody reaches that are left to try a new number on (row * numCols + col), and the biggest number each could take
+	int* cells;
+	int* largest;
+	int numCells;
+
+	//Square being tried and the sizes left to try on it, cell is -1 before one is picked
+	int cell;
+	int* sizes;
+	int numSizes;
+
+	//A number is sitting on cell for the step above this one
+	bool placed;
+
+	//Squares (per row) the numbers so far could reach and squares they have to take, how many arrows they still need
+	// and how many squares are empty. A new number only ever goes where nobody reaches, so it can't change anything
+	// about the numbers already down, and the next step just adds the new number on to these.
+	uint64_t* covered;
+	uint64_t* needed;
+	int needSquares;
+	int openSquares;
+};
+
+//What a region searched on its own has found, see Solver::splitRegions
+struct RegionAnswers {
+	//The arrows each answer put down (cell * 4 + dir), only kept when solutions are being saved
+	std::vector<std::vector<int>> arrows;
+
+	//The board's hash with each answer on it, only kept when counting with a hash of the solutions
+	std::vector<uint64_t> hashes;
+
+	//How many answers there are
+	uint64_t count;
+
+	RegionAnswers() : count(0) {}
+};
+
+//Gets handed each solution the moment it's found, see Solver::streamSolutions
+// The grid belongs to the solver and gets written over for the next solution, so copy out anything worth keeping.
+typedef std::function<void(Cell** solution)> SolutionSink;
+
+class Solver;
+
+//Gathers what every thread of a parallel solve finds
+struct SolutionCollector {
+	std::mutex lock;
+	std::vector<Cell**> solutions;
+	double guesses;
+
+	//Hashes of every solution handed over so far, so each one is only kept once
+	std::unordered_set<uint64_t> seen;
+
+	//Same as the solver's, 0 for no limit. stop gets raised for every thread once the limit is hit
+	size_t limit;
+	std::atomic<bool> stop;
+
+	SolutionCollector(size_t solutionLimit) : guesses(0), limit(solutionLimit), stop(false) {}
+
+	//Hands over the solution on a thread's board along with its hash, repeats get thrown out
+	void add(const Solver &found, uint64_t key);
+
+	//Adds on the guesses a thread made
+	void addGuesses(double guessed);
+};
+
+class Solver {
+public:
+	//Sets up a solver for a puzzle grid of spaces, numbers and arrows
+	Solver(Cell** puzzle, int rows, int cols);
+
+	//Keeps track of what operating mode we want
+	int mode;
+
+	//Difficulty is rated based on size, number of numbers, and number of guesses.
+	double difficultyRate;
+
+	//Puzzle creation only keeps a unique puzzle if its rating (see rating) is in here, anything else gets passed over
+	// like a puzzle that isn't unique. 0 to 10 takes anything.
+	// Creation gives up after maxCreationSolves candidate puzzles, a band that can't be reached would otherwise have
+	// it search the whole creation tree (which can take hours). creationSolves is how many the last creation solved.
+	double lowestRating;
+	double highestRating;
+	uint64_t maxCreationSolves;
+	uint64_t creationSolves;
+
+	//How to guess, see Branching
+	int branching;
+
+	//Memory for the table of boards the backtracker has finished with, 0 to go without one
+	size_t tableBytes;
+
+	//Stop the search once this many different solutions are found, 0 to find them all
+	size_t solutionLimit;
+
+	//Where puzzle creation's random choices come from, the same seed and starting grid always make the same puzzle
+	uint64_t seed;
+
+	//Solves from a puzzle grid, solutions get pushed on as they are found
+	void backtracker(std::vector<Cell**> &solutions, Cell** puzzleState);
+
+	//Solves from a puzzle grid using a pool of threads (0 for one per core), each guess branch can become its own task
+	void parallelBacktracker(std::vector<Cell**> &solutions, Cell** puzzleState, int threads = 0);
+
+	//Solves from a puzzle grid as an exact cover problem, every number picks one placement and every square gets covered once
+	void dancingLinks(std::vector<Cell**> &solutions, Cell** puzzleState);
+
+	//Checks if a puzzle grid has exactly one solution, gives up as soon as it finds a second
+	bool isUnique(Cell** puzzleState);
+
+	//Counts the solutions of a puzzle grid without keeping any of them, up to solutionLimit if there is one
+	// If solutionsHash is given it gets a hash of every solution found, the same whatever order they turned up in.
+	uint64_t countSolutions(Cell** puzzleState, uint64_t* solutionsHash = NULL);
+
+	//Hands every solution of a puzzle grid to sink as soon as it's found instead of keeping them, up to solutionLimit
+	// returns: how many solutions went to the sink
+	uint64_t streamSolutions(Cell** puzzleState, const SolutionSink &solutionSink);
+
+	//Finishes creating a puzzle from a grid, see the definition for details
+	void puzzleCreation(Cell** puzzleState, std::vector<Cell**> &solutions);
+
+	//Rates a puzzle from 1 up to 10 (10 being extremely hard) from the guesses solving it took and how many solutions it has
+	double rating(double guesses, size_t numSolutions) const;
+
+	//Prints a single representation of the puzzle
+	void printPuzzle(Cell** puzzle) const;
+
+	//The grid for the board the solver is on right now
+	Cell** currentPuzzle() const;
+
+	//How many guesses deep the search is, and roughly how much of it is done (0 to 1), for keeping an eye on long solves
+	size_t searchDepth() const;
+	double searchProgress() const;
+
+private:
+	int numRows;
+	int numCols;
+
+	//Every number on the board, sorted by value
+	std::vector<number> numbers;
+	int numNumbers;
+
+	//How many numbers still have arrows left to place, kept up to date as arrows go down and come back up
+	int numUnfinished;
+
+	//Index into numbers of the number sitting on each square, -1 if there isn't one
+	int numberAt[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+
+	//Keeps track of which number we are working on in the numbers array
+	int currentNumber;
+
+	//The one board the backtracker works on, it gets changed in place and put back using the trail
+	Bitboard board;
+
+	//Every square the backtracker has filled, in order, so they can be emptied again when we back up
+	std::vector<int> trail;
+
+	//Every placement each number could still use, numbers[k]'s are the first domainSize[k] entries of domain from domainStart[k]
+	// Placements that die get swapped past the end, so putting a domain back is just putting its size back.
+	std::vector<placement> places;
+	std::vector<int> domain;
+	std::vector<int> domainStart;
+	std::vector<int> domainSize;
+
+	//Which number's domain shrank and what size it was before, so the backtracker can grow them back
+	std::vector<std::pair<int, int>> domainTrail;
+
+	//Numbers with a square in their row or column changed since their domain was last pruned
+	std::vector<char> dirty;
+
+	//Every number (index into numbers) in each row and column
+	std::vector<std::vector<int>> rowNumbers;
+	std::vector<std::vector<int>> colNumbers;
+
+	//Where each number's rays start, [k * 4 + dir] is upToAlongRay for numbers[k] in dir (see rayRuns)
+	std::vector<uint64_t> rayStart;
+
+	//The reach the node above finished with, so a new node only has to work out what its guess changed. NULL to work it all out
+	const uint64_t* parentReach;
+
+	//Set during a parallel solve, branches get handed to the pool and report back to the collector
+	WorkStealingPool* pool;
+	SolutionCollector* collector;
+
+	//Boards already searched, shared with every branch split off from this solver
+	std::shared_ptr<TranspositionTable> table;
+
+	//Zobrist hash of the arrows on the board, kept up to date by placeArrow and undoTo
+	uint64_t hash;
+
+	//Branches handed to the pool so far, a board whose search handed some off isn't finished with yet
+	int handOffs;
+
+	//Hashes of the solutions found so far, so the same one never gets saved twice
+	std::unordered_set<uint64_t> seenSolutions;
+
+	//While a region is searched on its own, the numbers in it, its squares (per row), where its arrows
+	// start on the trail and the answers it has found so far. partials is NULL when the whole board is being searched.
+	std::vector<char> activeNumber;
+	uint64_t region[MAX_BOARD_SIZE];
+	size_t regionMark;
+	RegionAnswers* partials;
+
+	//Set once the solution limit is hit so every level of the search backs straight out
+	bool stopped;
+
+	//Set for a count only solve, solutions found just add to solutionCount (and get mixed into solutionHash
+	// when hashSolutions is set) so nothing is kept per solution
+	bool countOnly;
+	bool hashSolutions;
+	uint64_t solutionCount;
+	uint64_t solutionHash;
+
+	//Set while streaming, solutions get written into sinkGrid and handed to it instead of being saved
+	const SolutionSink* sink;
+	Cell** sinkGrid;
+
+	//Scratch buffers for every level of the search and of puzzle creation, see ScratchArena
+	ScratchArena scratch;
+
+	//Every node the backtracker and every step puzzle creation is in the middle of, innermost last
+	std::vector<SearchFrame> searchStack;
+	std::vector<CreationFrame> creationStack;
+
+	void arrowChanged(int row, int col, int dir, int change);
+	void placeArrow(int row, int col, int dir);
+	void undoTo(size_t mark);
+	void undoDomainsTo(size_t mark);
+	Bitboard loadBitboard(Cell** puzzle) const;
+	Cell** toPuzzle(const Bitboard &state) const;
+	void fillPuzzle(const Bitboard &state, Cell** puzzle) const;
+	uint64_t hashArrows(const Bitboard &state) const;
+	bool isSolved(const Bitboard &state) const;
+	bool isValid(const Bitboard &state) const;
+	void updateRemaining(const Bitboard &state);
+	void numberRays(const Bitboard &state, const int* which, int count, bool own, uint64_t* runs) const;
+	bool pruneDomains(uint64_t* reach, uint64_t* covered, uint64_t* shared, bool all);
+	bool needySquares(const uint64_t* reach, uint64_t* needs, uint64_t* needed) const;
+	void backtracker(std::vector<Cell**> &solutions);
+	void openNode(std::vector<Cell**> &solutions);
+	void closeNode();
+	bool propagate(std::vector<Cell**> &solutions, uint64_t* reach, bool all);
+	void backtracker(std::vector<Cell**> &solutions, const Bitboard &puzzleState);
+	void runBranch();
+	void guessPlacements(SearchFrame &frame);
+	void guessArrows(SearchFrame &frame);
+	void makeGuess(bool arrow, int guess);
+	bool splitRegions(std::vector<Cell**> &solutions, const uint64_t* reach);
+	bool regionSolved() const;
+	void foundSolution(std::vector<Cell**> &solutions);
+	void countRegions(const std::vector<RegionAnswers> &answers, size_t* pick, bool solves);
+	void countSolution(uint64_t key);
+	void takePlacement(const placement &place);
+	Solver* splitOff() const;
+	void handOff(Solver* branch);
+	bool shouldStop() const;
+	void saveSolution(std::vector<Cell**> &solutions);
+	void solveUpTo(std::vector<Cell**> &solutions, const Bitboard &puzzleState, size_t limit);
+	void freeSolutions(std::vector<Cell**> &solutions) const;
+	void placementsFor(const Bitboard &state, int k, std::vector<placement> &found) const;
+	void applyPlacement(Bitboard &state, const placement &place) const;
+	void buildDomains();
+	void openCreation(Cell** puzzle, std::vector<Cell**> &solutions);
+	bool creationSolved(const Bitboard &state, std::vector<Cell**> &solutions);
+	void growCreation(const Bitboard &state, std::vector<Cell**> &solutions, int row, int col, int value);
+	void pushCreation(const Bitboard &state, ArenaMark frame, uint64_t* covered, uint64_t* needed, int needSquares, int openSquares);
+	bool newNumberReach(const Bitboard &state, int row, int col, int value, uint64_t* reach, uint64_t* needs, int &remaining) const;
+	bool pruneDomain(int k, uint64_t rowBlocked, uint64_t colBlocked, uint64_t rowNeeded, uint64_t colNeeded);
+};
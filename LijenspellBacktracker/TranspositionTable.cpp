@@ -0,0 +1,42 @@
+//
+// TranspositionTable.cpp : Remembers boards the backtracker has already finished with
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TranspositionTable.h"
+using namespace std;
+
+//Uses about bytes of memory
+TranspositionTable::TranspositionTable(size_t bytes) : salt(0), searches(0) {
+	size_t count = 1;
+	while (count * 2 * sizeof(atomic<uint64_t>) <= bytes) {
+		count *= 2;
+	}
+	entries.reset(new atomic<uint64_t>[count]);
+	for (size_t i = 0; i < count; i++) {
+		entries[i].store(0, memory_order_relaxed);
+	}
+	mask = count - 1;
+	newSearch();
+}
+
+//Forgets everything
+void TranspositionTable::newSearch() {
+	salt.store(mix64((++searches) << 32), memory_order_relaxed);
+}
+
+//Has this board been finished with already
+bool TranspositionTable::contains(uint64_t key) const {
+	uint64_t stored = key ^ salt.load(memory_order_relaxed);
+	return entries[key & mask].load(memory_order_relaxed) == stored;
+}
+
+//Marks a board as finished with
+void TranspositionTable::insert(uint64_t key) {
+	entries[key & mask].store(key ^ salt.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+//Memory used by the entries
+size_t TranspositionTable::bytes() const {
+	return (mask + 1) * sizeof(atomic<uint64_t>);
+}
@@ -0,0 +1,55 @@
+//
+// TranspositionTable.h : Remembers boards the backtracker has already finished with
+//
+//  Placing arrows one at a time means the same partial board can be reached in more than one order. Once the
+//  backtracker has completely searched under a board (found it dead, or found every solution under it) the board's
+//  Zobrist hash goes in here and any later path that reaches it again can skip straight past it.
+//  Entries are single atomic words so threads of a parallel solve can share one table.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+
+//Scrambles a number into a random looking 64 bit word (the splitmix64 finalizer)
+inline uint64_t mix64(uint64_t x) {
+	x = (x + 1) * 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+//Random looking key for a square holding a state, the hash of a board is all of its arrows' keys xored together
+// Worked out on the fly so there is no table to set up.
+inline uint64_t zobristKey(int row, int col, int state) {
+	return mix64(((uint64_t)row * 64 + col) * 8 + state);
+}
+
+class TranspositionTable {
+public:
+	//Uses about bytes of memory, rounded down to a power of two number of entries
+	explicit TranspositionTable(size_t bytes);
+
+	//Forgets everything, for when a new puzzle (or the same one again) gets searched
+	void newSearch();
+
+	//Has this board been finished with already
+	bool contains(uint64_t key) const;
+
+	//Marks a board as finished with, older boards that land in the same entry get bumped out
+	void insert(uint64_t key);
+
+	//Memory used by the entries
+	size_t bytes() const;
+
+private:
+	std::unique_ptr<std::atomic<uint64_t>[]> entries;
+	uint64_t mask;
+
+	//Mixed into every stored key, a new salt makes every old entry stop matching without clearing them
+	std::atomic<uint64_t> salt;
+	std::atomic<uint64_t> searches;
+};
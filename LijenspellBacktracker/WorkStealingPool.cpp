@@ -0,0 +1,113 @@
+//
+// WorkStealingPool.cpp : A small work stealing thread pool for splitting up the backtracker's search
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WorkStealingPool.h"
+using namespace std;
+
+//Which pool queue belongs to the current thread, -1 for threads that aren't workers
+static thread_local int workerIndex = -1;
+
+WorkStealingPool::WorkStealingPool(int threads) : pending(0), queued(0), stopping(false) {
+	if (threads <= 0) {
+		threads = (int)thread::hardware_concurrency();
+		if (threads <= 0) {
+			threads = 1;
+		}
+	}
+	for (int i = 0; i < threads; i++) {
+		queues.push_back(unique_ptr<Queue>(new Queue()));
+	}
+	for (int i = 0; i < threads; i++) {
+		workers.push_back(thread(&WorkStealingPool::run, this, i));
+	}
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	{
+		lock_guard<mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (int i = 0; i < (int)workers.size(); i++) {
+		workers[i].join();
+	}
+}
+
+void WorkStealingPool::submit(function<void()> task) {
+	//Workers keep their own work, anyone else spreads it around
+	int index = workerIndex;
+	if (index < 0) {
+		index = (int)(pending.load() % queues.size());
+	}
+	pending++;
+	{
+		lock_guard<mutex> guard(queues[index]->lock);
+		queues[index]->tasks.push_back(task);
+	}
+	queued++;
+	{
+		//Taking the lock makes sure a worker about to sleep sees the new task
+		lock_guard<mutex> guard(sleepLock);
+	}
+	wake.notify_one();
+}
+
+void WorkStealingPool::wait() {
+	unique_lock<mutex> guard(sleepLock);
+	done.wait(guard, [this]() { return pending.load() == 0; });
+}
+
+bool WorkStealingPool::hungry() const {
+	return queued.load() < (int)workers.size();
+}
+
+int WorkStealingPool::size() const {
+	return (int)workers.size();
+}
+
+//Grabs the next task for a worker, newest from its own queue or else the oldest from someone else's
+bool WorkStealingPool::take(int index, function<void()> &task) {
+	{
+		lock_guard<mutex> guard(queues[index]->lock);
+		if (!queues[index]->tasks.empty()) {
+			task = queues[index]->tasks.back();
+			queues[index]->tasks.pop_back();
+			queued--;
+			return true;
+		}
+	}
+	for (int i = 1; i < (int)queues.size(); i++) {
+		Queue &victim = *queues[(index + i) % queues.size()];
+		lock_guard<mutex> guard(victim.lock);
+		if (!victim.tasks.empty()) {
+			task = victim.tasks.front();
+			victim.tasks.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkStealingPool::run(int index) {
+	workerIndex = index;
+	function<void()> task;
+	while (true) {
+		if (take(index, task)) {
+			task();
+			task = nullptr;
+			if (--pending == 0) {
+				lock_guard<mutex> guard(sleepLock);
+				done.notify_all();
+			}
+			continue;
+		}
+		unique_lock<mutex> guard(sleepLock);
+		wake.wait(guard, [this]() { return stopping.load() || queued.load() > 0; });
+		if (stopping) {
+			return;
+		}
+	}
+}
@@ -0,0 +1,60 @@
+//
+// WorkStealingPool.h : A small work stealing thread pool for splitting up the backtracker's search
+//
+//  Each worker has its own queue. Tasks a worker submits go on the back of its own queue and it works them
+//  back first (so it stays deep in the part of the tree it already has warm), while idle workers steal from
+//  the front of everyone else's queue (the oldest, usually biggest, subtrees).
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+	//threads of 0 uses one worker per core
+	explicit WorkStealingPool(int threads = 0);
+	~WorkStealingPool();
+
+	//Queues up a task, tasks are free to submit more tasks
+	void submit(std::function<void()> task);
+
+	//Blocks until every task (and every task they submitted) has finished
+	void wait();
+
+	//True when there is less queued work than workers, so splitting off more tasks is worth it
+	bool hungry() const;
+
+	//Number of worker threads
+	int size() const;
+
+private:
+	struct Queue {
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+
+	//Tasks submitted but not finished yet, and tasks sitting in a queue
+	std::atomic<int> pending;
+	std::atomic<int> queued;
+	std::atomic<bool> stopping;
+
+	//Idle workers sleep on wake, wait() sleeps on done
+	std::mutex sleepLock;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	void run(int index);
+	bool take(int index, std::function<void()> &task);
+};